@@ -9,6 +9,11 @@ import os
 import argparse
 import time
 
+try:
+    import msgpack
+except ImportError:
+    msgpack = None
+
 # Add parent directory to path to import common module
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..'))
 
@@ -121,7 +126,7 @@ def test_alarm_features(tester: APITester):
         "Get Alarm History",
         "GET",
         "/device/alarms/history",
-        expected_fields=["history"]
+        expected_fields=["history", "next", "latest"]
     )
     tester.add_result(test)
 
@@ -130,9 +135,46 @@ def test_alarm_features(tester: APITester):
         tester.add_result(TestCase(
             "Alarm History",
             TestResult.PASS,
-            f"History contains {len(history)} entries"
+            f"History contains {len(history)} entries, latest seq {test.response['latest']}"
+        ))
+
+        # Walk the history two records at a time; each page must start after the last cursor
+        cursor, seen, pages = 0, 0, 0
+        ordered = True
+        while pages < 50:
+            page = tester.session.get(f"{tester.api_url}/device/alarms/history",
+                                      params={"after": cursor, "limit": 2}, timeout=10).json()
+            seqs = [record["seq"] for record in page["history"]]
+            ordered &= all(seq > cursor for seq in seqs) and seqs == sorted(seqs)
+            seen += len(seqs)
+            cursor = page["next"]
+            pages += 1
+            if not page["more"]:
+                break
+        tester.add_result(TestCase(
+            "Alarm History Paging",
+            TestResult.PASS if ordered and not page["more"] else TestResult.FAIL,
+            f"{seen} records in {pages} pages, cursor at {cursor}"
         ))
 
+        # The same page as MessagePack
+        if msgpack is None:
+            tester.add_result(TestCase("Alarm History MessagePack", TestResult.SKIP, "pip install msgpack"))
+        else:
+            url = f"{tester.api_url}/device/alarms/history"
+            as_json = tester.session.get(url, params={"limit": 2}, timeout=10).json()
+            as_msgpack = tester.session.get(url, params={"limit": 2}, timeout=10,
+                                            headers={"Accept": "application/msgpack"})
+            decoded = (msgpack.unpackb(as_msgpack.content)
+                       if as_msgpack.headers.get("Content-Type") == "application/msgpack" else {})
+            same = (set(decoded) == set(as_json) and
+                    [r["seq"] for r in decoded.get("history", [])] == [r["seq"] for r in as_json["history"]])
+            tester.add_result(TestCase(
+                "Alarm History MessagePack",
+                TestResult.PASS if same else TestResult.FAIL,
+                f"Content-Type {as_msgpack.headers.get('Content-Type')}, {len(as_msgpack.content)} B"
+            ))
+
     # Test acknowledge alarm endpoint (may fail if no alarms)
     test = tester.test_endpoint(
         "Acknowledge Alarm",
@@ -252,6 +294,14 @@ def test_environmental_control(tester: APITester):
     )
     tester.add_result(test)
 
+    # Restore the culture defaults and read them back in one round trip
+    tester.test_batch([
+        {"op": "setpoint", "zone": 0, "temperature": 37.0},
+        {"op": "setpoint", "zone": 1, "temperature": 95.0},
+        {"op": "setpoint", "zone": 2, "temperature": 5.0},
+        {"op": "get_status"},
+    ])
+
 
 def combined_incubator_tests(tester: APITester):
     """Run all incubator tests in sequence"""
@@ -347,6 +347,12 @@ def pcr_specific_tests(tester: APITester):
         )
         tester.add_result(test)
 
+    # Setpoint plus status read in one round trip
+    tester.test_batch([
+        {"op": "setpoint", "zone": 0, "temperature": 95.0},
+        {"op": "get_status"},
+    ])
+
     # Get status to verify multi-zone support
     test = tester.test_endpoint(
         "Get PCR Status",
@@ -420,6 +426,53 @@ def pcr_specific_tests(tester: APITester):
                 f"Unexpected state: {state}"
             ))
 
+        # Two seconds in, the block is still heating from ambient: the hold
+        # countdown must not have started yet
+        step = test.response.get("phaseStep")
+        remaining = test.response.get("phaseTimeRemaining")
+        ramp_time = test.response.get("rampTime", 0)
+        if step is None:
+            tester.add_result(TestCase(
+                "Phase Ramp Gating",
+                TestResult.SKIP,
+                "Firmware does not report phaseStep"
+            ))
+        elif step == "RAMP" and test.response.get("holdTime") == 0 and ramp_time > 0:
+            tester.add_result(TestCase(
+                "Phase Ramp Gating",
+                TestResult.PASS,
+                f"Ramping for {ramp_time:.1f}s, hold of {remaining}s not started"
+            ))
+        else:
+            tester.add_result(TestCase(
+                "Phase Ramp Gating",
+                TestResult.FAIL,
+                f"phaseStep={step}, rampTime={ramp_time}, holdTime={test.response.get('holdTime')}"
+            ))
+
+        # The estimate covers every hold of the program plus predicted ramps
+        eta = test.response.get("eta")
+        total_remaining = test.response.get("totalTimeRemaining", 0)
+        holds = 180 + 30 * (30 + 30 + 60) + 300
+        if eta is None:
+            tester.add_result(TestCase(
+                "Program ETA",
+                TestResult.SKIP,
+                "Firmware does not report eta"
+            ))
+        elif total_remaining > holds and abs(eta - test.response.get("uptime", 0) - total_remaining) <= 1:
+            tester.add_result(TestCase(
+                "Program ETA",
+                TestResult.PASS,
+                f"{total_remaining}s remaining ({total_remaining - holds}s of ramps), eta at uptime {eta}s"
+            ))
+        else:
+            tester.add_result(TestCase(
+                "Program ETA",
+                TestResult.FAIL,
+                f"totalTimeRemaining={total_remaining}, eta={eta}, holds alone {holds}s"
+            ))
+
     # Stop the PCR (don't let it run full cycle in test)
     print(f"\n  {Color.YELLOW}Stopping PCR cycle (test mode)...{Color.RESET}")
     test = tester.test_endpoint(
@@ -0,0 +1,134 @@
+/**
+ * ProvisionPage.h
+ * Gzip-compressed captive portal page
+ * Generated by firmware/scripts/generate_assets.py from firmware/common/assets - do not edit
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef PROVISION_PAGE_H
+#define PROVISION_PAGE_H
+
+#include <Arduino.h>
+
+// Source: common/assets/provision.html (7205 bytes, minified 4898, gzip 1826)
+static const uint8_t PROVISION_PAGE_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58, 0x6d, 0x6f, 0xdb, 0x36,
+    0x10, 0xfe, 0xae, 0x5f, 0xc1, 0xb9, 0x28, 0x64, 0x6f, 0x96, 0xdf, 0x92, 0x38, 0x9d, 0xdf, 0x80,
+    0xad, 0x69, 0xb0, 0x0c, 0xeb, 0x0b, 0x96, 0x74, 0x43, 0x3f, 0xd2, 0x12, 0x65, 0xb1, 0x95, 0x44,
+    0x4d, 0xa4, 0xec, 0x78, 0x43, 0xfe, 0xfb, 0xee, 0x48, 0xea, 0xc5, 0xb2, 0xdd, 0xb5, 0xdb, 0x10,
+    0x20, 0x92, 0xc8, 0xbb, 0xe3, 0xdd, 0xc3, 0xbb, 0x87, 0x47, 0x2f, 0xbe, 0xb9, 0x79, 0xfb, 0xf2,
+    0xe1, 0xc3, 0xbb, 0x57, 0x24, 0x52, 0x49, 0xbc, 0x72, 0x16, 0xe5, 0x83, 0xd1, 0x00, 0x1e, 0x09,
+    0x53, 0x94, 0xf8, 0x11, 0xcd, 0x25, 0x53, 0xcb, 0xce, 0xfb, 0x87, 0x5b, 0xef, 0x45, 0xa7, 0x1c,
+    0x4e, 0x69, 0xc2, 0x96, 0x9d, 0x2d, 0x67, 0xbb, 0x4c, 0xe4, 0xaa, 0x43, 0x7c, 0x91, 0x2a, 0x96,
+    0x82, 0xd8, 0x8e, 0x07, 0x2a, 0x5a, 0x06, 0x6c, 0xcb, 0x7d, 0xe6, 0xe9, 0x8f, 0x3e, 0xe1, 0x29,
+    0x57, 0x9c, 0xc6, 0x9e, 0xf4, 0x69, 0xcc, 0x96, 0xe3, 0xc1, 0x08, 0xcd, 0x28, 0xae, 0x62, 0xb6,
+    0xfa, 0xe1, 0x91, 0x8b, 0x74, 0xff, 0x48, 0x6e, 0xb4, 0x02, 0xb9, 0x67, 0xaa, 0xc8, 0x16, 0x43,
+    0x33, 0xe7, 0x2c, 0xa4, 0xda, 0xe3, 0xf3, 0x5b, 0xf2, 0x17, 0x49, 0x68, 0xbe, 0xe1, 0xe9, 0x8c,
+    0x8c, 0xe6, 0x24, 0xa3, 0x41, 0xc0, 0xd3, 0x8d, 0x7e, 0x5f, 0x8b, 0x47, 0x4f, 0xf2, 0x3f, 0xf5,
+    0xe7, 0x5a, 0xe4, 0x01, 0xcb, 0x3d, 0x18, 0x9a, 0x93, 0x27, 0x67, 0x2d, 0x82, 0x3d, 0xf9, 0xcb,
+    0x09, 0xc1, 0x31, 0x2f, 0xa4, 0x09, 0x8f, 0xf7, 0x33, 0xe2, 0xd1, 0x2c, 0x8b, 0x99, 0x27, 0xf7,
+    0x52, 0xb1, 0xa4, 0x4f, 0x7e, 0x8c, 0x79, 0xfa, 0xe9, 0x35, 0xf5, 0xef, 0xf5, 0xf7, 0x2d, 0x48,
+    0xf6, 0x89, 0x7b, 0xcf, 0x36, 0x82, 0x91, 0xf7, 0x77, 0x6e, 0x9f, 0xfc, 0x2a, 0xd6, 0x42, 0x89,
+    0x3e, 0x91, 0x34, 0x95, 0x9e, 0x64, 0x39, 0x0f, 0xe7, 0xce, 0x9a, 0xfa, 0x9f, 0x36, 0xb9, 0x28,
+    0xd2, 0x60, 0x46, 0x40, 0x9d, 0xd1, 0xdc, 0xdb, 0xe4, 0x34, 0xe0, 0x10, 0x7c, 0x77, 0x7c, 0x71,
+    0x15, 0xb0, 0x4d, 0x9f, 0x3c, 0x9b, 0x4e, 0xaf, 0x19, 0xa3, 0x64, 0xf4, 0x1c, 0xde, 0xaf, 0xa7,
+    0x97, 0x6b, 0x3a, 0x21, 0xe3, 0xd1, 0xe8, 0x79, 0x6f, 0xee, 0x24, 0x3c, 0xf5, 0x22, 0xc6, 0x37,
+    0x91, 0x9a, 0xe1, 0xd0, 0x36, 0x9a, 0x3b, 0x01, 0x97, 0x59, 0x4c, 0xc1, 0xbb, 0x30, 0x66, 0x8f,
+    0x73, 0x87, 0xc6, 0x7c, 0x93, 0x7a, 0x1c, 0x1c, 0x92, 0x33, 0xe2, 0x83, 0x59, 0x96, 0xcf, 0x9d,
+    0x8f, 0x85, 0x54, 0x3c, 0xdc, 0x7b, 0x16, 0xe6, 0x7a, 0xa2, 0xc2, 0x62, 0x32, 0xca, 0x40, 0xf9,
+    0xc9, 0x19, 0xa0, 0x08, 0x05, 0xc7, 0x72, 0x08, 0xbe, 0xe9, 0xec, 0x2e, 0x02, 0x9b, 0xe0, 0xbf,
+    0x01, 0x09, 0x5d, 0x2e, 0x64, 0xa9, 0xa6, 0x51, 0x8c, 0x68, 0x20, 0x76, 0x00, 0xaa, 0x1e, 0x23,
+    0x53, 0xfc, 0x97, 0x6f, 0xd6, 0xb4, 0x3b, 0xea, 0xeb, 0xbf, 0xc1, 0x05, 0xba, 0x4f, 0x1f, 0xcd,
+    0xa6, 0xce, 0xc8, 0xe5, 0x48, 0xab, 0xda, 0x2f, 0x0c, 0xaf, 0xe1, 0xcd, 0x25, 0x6a, 0x5f, 0x58,
+    0x97, 0xa2, 0x31, 0xb8, 0xe2, 0x8b, 0x58, 0xe4, 0xb3, 0x12, 0x9a, 0xb9, 0xd9, 0x17, 0xd8, 0x39,
+    0x06, 0x3e, 0xbc, 0x40, 0x39, 0xb3, 0xc1, 0xb0, 0x7b, 0x4a, 0x89, 0x04, 0x0d, 0xe2, 0xa0, 0x62,
+    0x8f, 0xca, 0xd3, 0x88, 0xd4, 0x21, 0x43, 0x8c, 0xb2, 0x58, 0xeb, 0x14, 0x39, 0xb0, 0x3b, 0x3d,
+    0x2d, 0xde, 0xb2, 0x6b, 0x9c, 0x6a, 0xac, 0x3e, 0xbe, 0xb4, 0xc0, 0xd9, 0x9c, 0xe5, 0x69, 0x28,
+    0x5a, 0xd0, 0x3d, 0x0b, 0x5f, 0x84, 0xdf, 0x87, 0xf4, 0x08, 0x3c, 0xe3, 0x63, 0x15, 0xf4, 0xf8,
+    0xea, 0x44, 0x1c, 0x93, 0xab, 0x63, 0xf3, 0x7a, 0x77, 0x61, 0x8d, 0xd6, 0xce, 0x1f, 0x6d, 0xb2,
+    0xcc, 0x28, 0x68, 0xac, 0x99, 0xda, 0x31, 0x96, 0x1e, 0x59, 0x7e, 0xf1, 0x05, 0x81, 0xe8, 0x95,
+    0x66, 0x31, 0x95, 0xca, 0xf3, 0x23, 0x1e, 0x07, 0x55, 0x21, 0x55, 0x56, 0x46, 0x58, 0x2b, 0x07,
+    0x2a, 0x31, 0x5d, 0xb3, 0x18, 0x04, 0x9b, 0xc8, 0xb6, 0x65, 0xb6, 0x34, 0x2e, 0x58, 0x43, 0xe6,
+    0xe2, 0xe2, 0x62, 0x4e, 0xb4, 0x2f, 0x3b, 0x9b, 0xdc, 0xd3, 0x91, 0xb1, 0x1c, 0x8a, 0x3c, 0xf1,
+    0x10, 0xc8, 0x0c, 0x02, 0x6e, 0x63, 0x63, 0x13, 0xc4, 0xae, 0x58, 0xe3, 0xb1, 0x8e, 0x85, 0xff,
+    0x69, 0xee, 0x34, 0xad, 0x3b, 0x47, 0xd6, 0xbf, 0x14, 0x0f, 0x9e, 0x66, 0x05, 0x14, 0xb6, 0x64,
+    0x31, 0xf3, 0x15, 0xac, 0x72, 0x3a, 0x63, 0xc7, 0x13, 0xc8, 0x58, 0xb3, 0x83, 0x66, 0x97, 0xc1,
+    0x3d, 0x18, 0x91, 0x22, 0xe6, 0x01, 0x79, 0xc6, 0x46, 0xf8, 0x77, 0x26, 0x01, 0x9a, 0x6b, 0x6a,
+    0x03, 0x2a, 0x07, 0xc2, 0x00, 0xca, 0x13, 0x69, 0x45, 0x4a, 0x3a, 0x14, 0x02, 0x45, 0x24, 0x2b,
+    0x97, 0x66, 0xa1, 0xf0, 0x0b, 0x59, 0x3a, 0x66, 0xbe, 0xc0, 0x3d, 0x51, 0x28, 0xe4, 0x95, 0x19,
+    0x49, 0x45, 0x5a, 0xd7, 0x6b, 0xbb, 0x7c, 0x80, 0xdf, 0x0a, 0x08, 0x3b, 0x3d, 0x1f, 0x8f, 0x8e,
+    0xfe, 0x3f, 0xb2, 0x95, 0x5d, 0xf5, 0x80, 0x3a, 0x5a, 0x8e, 0x9d, 0x87, 0x62, 0x5a, 0x0d, 0x1c,
+    0xec, 0x9a, 0x5f, 0xe4, 0x12, 0x8d, 0x66, 0x82, 0x9b, 0x02, 0x6d, 0xa2, 0xa5, 0xdf, 0x31, 0x65,
+    0x00, 0xaa, 0x09, 0x60, 0x53, 0x13, 0x93, 0x1e, 0xa8, 0xe3, 0x9e, 0x45, 0x62, 0xab, 0x29, 0xae,
+    0xd2, 0xb0, 0xca, 0x31, 0x55, 0xec, 0x43, 0xd7, 0x83, 0xbd, 0xeb, 0xb5, 0x79, 0x0d, 0x5d, 0x34,
+    0xe4, 0xa6, 0x79, 0x6d, 0x3c, 0x9a, 0xf4, 0x61, 0xdb, 0xa7, 0x7d, 0x32, 0xb9, 0xb8, 0xec, 0x83,
+    0xfd, 0xcb, 0x5e, 0xc3, 0x3e, 0xf5, 0x15, 0xdf, 0xb2, 0xb3, 0x0b, 0x8c, 0xb4, 0xec, 0x20, 0x61,
+    0x52, 0xd2, 0x0d, 0x8a, 0x1d, 0x24, 0xd2, 0x11, 0x3a, 0x4d, 0x86, 0x53, 0x22, 0x2b, 0x53, 0xff,
+    0x14, 0x5f, 0x1d, 0x65, 0x70, 0x55, 0x15, 0x06, 0xf7, 0x7a, 0x55, 0xa0, 0x41, 0xdf, 0x87, 0xd7,
+    0x36, 0x5b, 0x05, 0x97, 0x2c, 0x08, 0x68, 0x5d, 0x3e, 0xe3, 0xab, 0xab, 0xeb, 0xc9, 0x65, 0xbd,
+    0x7f, 0xe3, 0x3a, 0xaf, 0xfd, 0x0b, 0x36, 0xf5, 0xd7, 0x07, 0x46, 0x59, 0x9e, 0x8b, 0xfc, 0x98,
+    0x00, 0x83, 0xeb, 0xa6, 0xc9, 0xeb, 0xc9, 0xd8, 0x3f, 0x63, 0x32, 0xbc, 0xf2, 0xad, 0xc9, 0xc5,
+    0xd0, 0x9e, 0xdf, 0x8b, 0xa1, 0xed, 0x28, 0xf0, 0x4c, 0x86, 0x47, 0xc0, 0xb7, 0xc4, 0x07, 0x52,
+    0x92, 0xcb, 0x4e, 0x75, 0x5a, 0x61, 0x4b, 0x10, 0x8d, 0x57, 0x0b, 0xe0, 0xbc, 0x94, 0xf0, 0x60,
+    0xd9, 0xd1, 0x04, 0xff, 0xb0, 0xcf, 0x58, 0x67, 0x65, 0x9a, 0x03, 0x30, 0x07, 0x73, 0xab, 0xb2,
+    0x47, 0x00, 0x61, 0x67, 0x91, 0x95, 0x76, 0xca, 0x13, 0xa1, 0xb3, 0x7a, 0x29, 0xd2, 0x90, 0x6f,
+    0x8a, 0x9c, 0x91, 0xbd, 0x28, 0x72, 0x62, 0x58, 0xcb, 0x95, 0xe4, 0x77, 0x7e, 0xcb, 0xb1, 0x4d,
+    0x49, 0xa1, 0xd8, 0x20, 0xd7, 0x16, 0xc3, 0xec, 0xd0, 0x93, 0x06, 0xbd, 0x75, 0xce, 0xce, 0x68,
+    0x3e, 0xc5, 0x69, 0xed, 0xe6, 0x89, 0x79, 0x4d, 0x65, 0xa5, 0xc7, 0xe4, 0xee, 0x66, 0x66, 0xbd,
+    0x3e, 0xaf, 0xa1, 0xa9, 0xb4, 0xa3, 0x43, 0x36, 0xc3, 0x77, 0x41, 0x67, 0xe5, 0x55, 0x6a, 0x43,
+    0x70, 0xe4, 0x3f, 0xbb, 0x83, 0x30, 0xfe, 0x0b, 0x4f, 0x0c, 0xfa, 0xff, 0xb3, 0x2f, 0xb7, 0x3c,
+    0x4f, 0x76, 0x34, 0xff, 0x3a, 0x7f, 0x42, 0xab, 0xf4, 0x1b, 0xcb, 0x25, 0x6c, 0xde, 0x09, 0xa7,
+    0xec, 0x43, 0x73, 0x07, 0x6a, 0xec, 0x78, 0xc8, 0x6f, 0xe1, 0xa3, 0xb5, 0x97, 0xf5, 0x71, 0x84,
+    0x13, 0xe6, 0xe0, 0x81, 0x31, 0x48, 0x20, 0xc9, 0x01, 0x77, 0x9d, 0x24, 0x6f, 0xe0, 0xc0, 0x15,
+    0xf9, 0xa7, 0xc5, 0x50, 0x4f, 0x83, 0x98, 0xa6, 0x6b, 0xa2, 0x00, 0x0d, 0x48, 0x4b, 0x28, 0x59,
+    0xe3, 0x93, 0xd6, 0xb0, 0x8d, 0xb0, 0x79, 0x87, 0x32, 0xf5, 0x59, 0x24, 0x62, 0x28, 0x89, 0x65,
+    0xe7, 0x15, 0x96, 0xb3, 0xc9, 0xba, 0xd4, 0x18, 0xd4, 0xb2, 0x1d, 0x92, 0xb3, 0x3f, 0x0a, 0x9e,
+    0x33, 0xac, 0x07, 0x99, 0xd0, 0x38, 0x26, 0xba, 0x4a, 0xb0, 0x14, 0x1a, 0xe7, 0x6d, 0x93, 0x05,
+    0x90, 0x50, 0x3a, 0x2b, 0x63, 0x4f, 0x45, 0x8c, 0xb0, 0x47, 0x20, 0x27, 0x6d, 0x8c, 0x88, 0xd0,
+    0x64, 0x79, 0x73, 0x19, 0x40, 0x06, 0xcd, 0x9e, 0xdc, 0xaf, 0xb3, 0xe1, 0x67, 0x30, 0x0d, 0xca,
+    0x00, 0xc1, 0x3b, 0xfb, 0x76, 0x3a, 0xfc, 0x4a, 0x4e, 0x43, 0x50, 0x7f, 0x19, 0x18, 0xea, 0xef,
+    0x13, 0x50, 0xd4, 0x93, 0x0d, 0x04, 0xbe, 0xc2, 0xc5, 0x44, 0x04, 0xa6, 0xbc, 0x6d, 0x05, 0x93,
+    0xd7, 0x30, 0x50, 0x7b, 0x69, 0xcf, 0x77, 0x74, 0x4b, 0x4b, 0x5a, 0x97, 0x8c, 0x96, 0xb3, 0x10,
+    0x99, 0xd6, 0xd1, 0x39, 0xb5, 0xec, 0x8c, 0xed, 0x56, 0xbf, 0x4d, 0xe3, 0xfd, 0x62, 0x68, 0xe6,
+    0x8e, 0x84, 0x26, 0x56, 0xe8, 0x3b, 0xf2, 0x93, 0x50, 0x32, 0x13, 0xaa, 0x21, 0x39, 0x34, 0xcb,
+    0xd5, 0x11, 0xd8, 0xe3, 0xd8, 0xa0, 0x04, 0x6c, 0x94, 0x70, 0x55, 0x39, 0x4b, 0x94, 0xd0, 0x3b,
+    0xb4, 0x18, 0x1a, 0x29, 0xd4, 0xc2, 0x30, 0x6d, 0xe0, 0xda, 0x65, 0xc3, 0xbe, 0x9d, 0x12, 0x85,
+    0xf2, 0x7b, 0xd5, 0xca, 0x6f, 0xe9, 0xe7, 0x3c, 0x83, 0x65, 0x43, 0xa6, 0xfc, 0xa8, 0xeb, 0x0e,
+    0x69, 0xc6, 0x87, 0xdb, 0xf1, 0xd0, 0x94, 0xcd, 0x10, 0xcb, 0xc6, 0xed, 0x39, 0x03, 0xc8, 0x92,
+    0xb4, 0xdb, 0xcd, 0x19, 0x38, 0x9d, 0x4a, 0xd6, 0x23, 0xcb, 0x15, 0x29, 0x3f, 0x06, 0x1f, 0xa5,
+    0x48, 0xbb, 0xbd, 0x4a, 0x08, 0x55, 0xb4, 0x00, 0xb4, 0x5f, 0xd0, 0x81, 0x24, 0x70, 0x0a, 0x0d,
+    0x36, 0x4c, 0xbd, 0x8a, 0x19, 0xbe, 0xfe, 0xb8, 0xbf, 0x0b, 0xba, 0x6e, 0x45, 0xc5, 0x6e, 0x6f,
+    0x80, 0xf9, 0xff, 0xd2, 0x34, 0xa8, 0x64, 0x49, 0x50, 0x7b, 0x80, 0x31, 0xcf, 0xcf, 0x6b, 0x97,
+    0xac, 0x76, 0x5a, 0x99, 0x07, 0xff, 0xa8, 0xfa, 0xaf, 0x57, 0x6e, 0xb1, 0xc6, 0x69, 0x1b, 0x2d,
+    0x21, 0x38, 0xb8, 0x00, 0x1b, 0x9f, 0x22, 0xbc, 0x5d, 0x03, 0xcc, 0x53, 0xef, 0x33, 0x6b, 0x94,
+    0x3c, 0x03, 0xc6, 0xa1, 0x03, 0x78, 0xb5, 0x85, 0x89, 0x5f, 0x38, 0x5c, 0x27, 0xe1, 0x48, 0xeb,
+    0xba, 0x26, 0x0f, 0xe0, 0x26, 0x49, 0xe5, 0x3e, 0xf5, 0x49, 0x97, 0x59, 0xa4, 0xd9, 0x20, 0xcb,
+    0x19, 0x8a, 0xde, 0xb0, 0x90, 0x16, 0xb1, 0xea, 0xea, 0x5e, 0x2b, 0x95, 0x0a, 0x33, 0x3d, 0xb9,
+    0xa1, 0x70, 0xc1, 0x5e, 0x82, 0x18, 0xb2, 0xca, 0x8c, 0x9c, 0x5d, 0x1a, 0xa7, 0x61, 0x59, 0x9d,
+    0xad, 0x7d, 0xa7, 0x2c, 0xaf, 0xcf, 0x28, 0x94, 0x22, 0xb5, 0x12, 0x56, 0x07, 0xb4, 0x62, 0x78,
+    0xc5, 0xbf, 0x83, 0x96, 0xf0, 0xac, 0x26, 0xca, 0x95, 0x5a, 0x3d, 0xe7, 0x09, 0x9b, 0xb6, 0xbd,
+    0xbe, 0x7c, 0xa1, 0xcf, 0x65, 0x6a, 0x81, 0xcf, 0x74, 0x47, 0x39, 0x04, 0x71, 0x98, 0x9c, 0x08,
+    0xd1, 0xd0, 0x2f, 0x8f, 0x65, 0x40, 0x03, 0x2e, 0x02, 0x4c, 0x45, 0x02, 0x5c, 0x75, 0xdf, 0xbd,
+    0xbd, 0x7f, 0x70, 0xfb, 0x0e, 0xf6, 0x07, 0x80, 0xff, 0x0c, 0xae, 0x14, 0xae, 0xdd, 0x1f, 0x4f,
+    0x6f, 0x3b, 0x88, 0xe0, 0x9d, 0x9d, 0xc3, 0x86, 0xc0, 0xe6, 0x0c, 0x31, 0x79, 0x5d, 0xf2, 0xd4,
+    0xd7, 0xb7, 0xfb, 0x19, 0xf9, 0xf9, 0xfe, 0xed, 0x9b, 0x81, 0x54, 0x39, 0x34, 0x5e, 0x70, 0x71,
+    0xea, 0x96, 0xe0, 0x81, 0x87, 0x15, 0xa0, 0x81, 0x01, 0xd3, 0x38, 0xd6, 0x2a, 0x82, 0xb9, 0xc3,
+    0x43, 0xd2, 0x45, 0x89, 0xb2, 0x95, 0xea, 0x21, 0xea, 0x91, 0xd8, 0xbd, 0x36, 0xe5, 0xd7, 0x75,
+    0xcb, 0xae, 0xc1, 0xf8, 0x1e, 0x7c, 0x53, 0xfe, 0x50, 0xc1, 0x65, 0xd5, 0x4b, 0xa4, 0x9b, 0xc1,
+    0x60, 0x00, 0x51, 0xb9, 0xd6, 0x86, 0x0b, 0x76, 0x25, 0x53, 0x0f, 0x3c, 0x61, 0xd0, 0xcb, 0x97,
+    0x49, 0x74, 0x68, 0xf6, 0x83, 0x28, 0x88, 0x0f, 0xa7, 0x5e, 0x0a, 0x8d, 0xad, 0x1f, 0x0b, 0xc0,
+    0x4e, 0x45, 0x60, 0x32, 0x83, 0xc9, 0x96, 0xa5, 0xa7, 0x3e, 0x5c, 0x59, 0x47, 0xba, 0xdd, 0x24,
+    0x2c, 0x96, 0xac, 0x6d, 0xa9, 0x6c, 0x77, 0x34, 0x3e, 0x24, 0xa4, 0x3c, 0x66, 0x88, 0x2b, 0x90,
+    0x96, 0x8e, 0x4b, 0x77, 0x73, 0x60, 0x51, 0x3f, 0xb5, 0x3d, 0xb0, 0xa3, 0xb3, 0x1b, 0xb2, 0x11,
+    0xc7, 0x8e, 0x22, 0xbe, 0xd5, 0x26, 0x90, 0xb2, 0xaa, 0xb0, 0x35, 0x79, 0xb9, 0x2d, 0x2b, 0xf0,
+    0x3f, 0x2c, 0x52, 0xc3, 0xc4, 0x4d, 0x03, 0x58, 0x62, 0x7d, 0xcd, 0x83, 0xbd, 0x2a, 0x43, 0x2c,
+    0x9b, 0xdd, 0x00, 0xd9, 0x2d, 0xcf, 0xa7, 0xa7, 0x95, 0x42, 0xfb, 0xb5, 0x42, 0xab, 0x64, 0xf1,
+    0xeb, 0x60, 0x5a, 0xf3, 0xe5, 0x1b, 0x3c, 0x0b, 0x97, 0xa4, 0xb4, 0xa0, 0xc3, 0x37, 0xdc, 0xd0,
+    0x90, 0xd4, 0xc7, 0xec, 0xc0, 0x76, 0xd3, 0x28, 0xad, 0x6f, 0x99, 0xae, 0xed, 0x54, 0x2d, 0xaf,
+    0x02, 0x45, 0x9b, 0x1e, 0x75, 0xa8, 0x7f, 0x0b, 0xfb, 0x1b, 0x67, 0xab, 0x31, 0x51, 0x22, 0x13,
+    0x00, 0x00,
+};
+static const size_t PROVISION_PAGE_GZ_LEN = 1826;
+static const char PROVISION_PAGE_ETAG[] = "\"4fdc1e60648a9836\"";
+
+#endif // PROVISION_PAGE_H
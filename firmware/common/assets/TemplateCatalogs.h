@@ -0,0 +1,55 @@
+/**
+ * TemplateCatalogs.h
+ * Flash-resident template catalogs for the REST API
+ * Generated by firmware/scripts/generate_assets.py from firmware/common/assets - do not edit
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef TEMPLATE_CATALOGS_H
+#define TEMPLATE_CATALOGS_H
+
+#include <Arduino.h>
+
+#ifdef DEVICE_TYPE_PCR
+// Source: common/assets/program_templates.json
+static const char PROGRAM_TEMPLATES_JSON[] PROGMEM =
+    "{\"templates\":[{\"name\":\"Standard PCR\",\"type\":\"standard\",\"description\":\"Basic PCR pro"
+    "tocol for general amplification\",\"cycles\":35,\"initialDenatureTemp\":95.0,\"initialDenatureTi"
+    "me\":180,\"denatureTemp\":95.0,\"denatureTime\":30,\"annealTemp\":55.0,\"annealTime\":30,\"exten"
+    "dTemp\":72.0,\"extendTime\":60,\"finalExtendTemp\":72.0,\"finalExtendTime\":300},{\"name\":\"Fas"
+    "t PCR\",\"type\":\"twostep\",\"description\":\"Faster cycling for amplicons <500bp\",\"twoStepEn"
+    "abled\":true,\"cycles\":30,\"initialDenatureTemp\":95.0,\"initialDenatureTime\":120,\"denatureTe"
+    "mp\":95.0,\"denatureTime\":15,\"annealExtendTemp\":68.0,\"annealExtendTime\":30,\"finalExtendTem"
+    "p\":72.0,\"finalExtendTime\":180},{\"name\":\"High Specificity\",\"type\":\"touchdown\",\"descri"
+    "ption\":\"Reduce non-specific amplification via touchdown\",\"cycles\":35,\"initialDenatureTemp"
+    "\":95.0,\"initialDenatureTime\":180,\"denatureTemp\":95.0,\"denatureTime\":30,\"extendTemp\":72."
+    "0,\"extendTime\":60,\"finalExtendTemp\":72.0,\"finalExtendTime\":300,\"touchdown\":{\"enabled\":"
+    "true,\"startAnnealTemp\":65.0,\"endAnnealTemp\":50.0,\"stepSize\":1.0,\"touchdownCycles\":15}},{"
+    "\"name\":\"Sensitive Detection\",\"type\":\"standard\",\"description\":\"More cycles for low-cop"
+    "y templates\",\"cycles\":40,\"initialDenatureTemp\":95.0,\"initialDenatureTime\":180,\"denatureT"
+    "emp\":95.0,\"denatureTime\":30,\"annealTemp\":50.0,\"annealTime\":45,\"extendTemp\":72.0,\"exten"
+    "dTime\":90,\"finalExtendTemp\":72.0,\"finalExtendTime\":300},{\"name\":\"Long Amplicon\",\"type"
+    "\":\"standard\",\"description\":\"Extended extension time for fragments >1 kb\",\"cycles\":30,\""
+    "initialDenatureTemp\":95.0,\"initialDenatureTime\":240,\"denatureTemp\":95.0,\"denatureTime\":30"
+    ",\"annealTemp\":55.0,\"annealTime\":30,\"extendTemp\":68.0,\"extendTime\":120,\"finalExtendTemp"
+    "\":68.0,\"finalExtendTime\":600}]}";
+static const size_t PROGRAM_TEMPLATES_JSON_LEN = 1677;
+static const char PROGRAM_TEMPLATES_ETAG[] = "\"5cd115c85bca9e83\"";
+#endif
+
+#ifdef DEVICE_TYPE_INCUBATOR
+// Source: common/assets/protocol_templates.json
+static const char PROTOCOL_TEMPLATES_JSON[] PROGMEM =
+    "{\"templates\":[{\"name\":\"Mammalian Cell Culture\",\"type\":0,\"description\":\"Standard mamma"
+    "lian cell culture with 30-minute pre-heat ramp\",\"stages\":2},{\"name\":\"Bacterial Growth (E. "
+    "coli)\",\"type\":1,\"description\":\"Standard E. coli culture with 15-minute warm-up\",\"stages"
+    "\":2},{\"name\":\"Yeast Culture\",\"type\":2,\"description\":\"Standard yeast culture at 30\302"
+    "\260C with 10-minute pre-heat\",\"stages\":2},{\"name\":\"Decontamination Cycle\",\"type\":3,\"d"
+    "escription\":\"High-temperature cleaning cycle (65\302\260C for 2 hours)\",\"stages\":3},{\"name"
+    "\":\"Multi-Temperature Expression\",\"type\":4,\"description\":\"Three-stage protocol for protei"
+    "n expression optimization\",\"stages\":3}]}";
+static const size_t PROTOCOL_TEMPLATES_JSON_LEN = 639;
+static const char PROTOCOL_TEMPLATES_ETAG[] = "\"c7ab2152c7990daf\"";
+#endif
+
+#endif // TEMPLATE_CATALOGS_H
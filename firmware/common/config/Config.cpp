@@ -68,7 +68,8 @@ bool DeviceConfig::save() {
         return false;
     }
 
-    String jsonStr = toJSON();
+    JsonDocument doc;
+    toJSON(doc);
 
     File file = FSYS.open(CONFIG_FILE, "w");
     if (!file) {
@@ -76,7 +77,7 @@ bool DeviceConfig::save() {
         return false;
     }
 
-    size_t bytesWritten = file.print(jsonStr);
+    size_t bytesWritten = serializeJsonPretty(doc, file);
     file.close();
 
     if (bytesWritten > 0) {
@@ -102,51 +103,68 @@ void DeviceConfig::reset() {
 
 String DeviceConfig::toJSON() const {
     JsonDocument doc;
+    toJSON(doc);
 
+    String jsonStr;
+    serializeJsonPretty(doc, jsonStr);
+    return jsonStr;
+}
+
+void DeviceConfig::toJSON(JsonDocument& doc, const FieldList& sections) const {
     // Device information
-    JsonObject deviceObj = doc["device"].to<JsonObject>();
-    deviceObj["id"] = device.id;
-    deviceObj["type"] = device.type;
-    deviceObj["name"] = device.name;
-    deviceObj["serialNumber"] = device.serialNumber;
-    deviceObj["firmwareVersion"] = device.firmwareVersion;
+    if (sections.includes("device")) {
+        JsonObject deviceObj = doc["device"].to<JsonObject>();
+        deviceObj["id"] = device.id;
+        deviceObj["type"] = device.type;
+        deviceObj["name"] = device.name;
+        deviceObj["serialNumber"] = device.serialNumber;
+        deviceObj["firmwareVersion"] = device.firmwareVersion;
+    }
 
     // WiFi configuration
-    JsonObject wifiObj = doc["wifi"].to<JsonObject>();
-    wifiObj["mode"] = static_cast<int>(wifi.mode);
-    wifiObj["ssid"] = wifi.ssid;
-    wifiObj["password"] = wifi.password; // TODO: Encrypt in production
-    wifiObj["apSSID"] = wifi.apSSID;
-    wifiObj["apPassword"] = wifi.apPassword;
-    wifiObj["staticIP"] = wifi.staticIP;
-    wifiObj["ip"] = wifi.ip;
-    wifiObj["gateway"] = wifi.gateway;
-    wifiObj["subnet"] = wifi.subnet;
+    if (sections.includes("wifi")) {
+        JsonObject wifiObj = doc["wifi"].to<JsonObject>();
+        wifiObj["mode"] = static_cast<int>(wifi.mode);
+        wifiObj["ssid"] = wifi.ssid;
+        wifiObj["password"] = wifi.password; // TODO: Encrypt in production
+        wifiObj["apSSID"] = wifi.apSSID;
+        wifiObj["apPassword"] = wifi.apPassword;
+        wifiObj["staticIP"] = wifi.staticIP;
+        wifiObj["ip"] = wifi.ip;
+        wifiObj["gateway"] = wifi.gateway;
+        wifiObj["subnet"] = wifi.subnet;
+    }
 
     // Network configuration
-    JsonObject networkObj = doc["network"].to<JsonObject>();
-    networkObj["httpPort"] = network.httpPort;
-    networkObj["wsPort"] = network.wsPort;
-    networkObj["mdnsEnabled"] = network.mdnsEnabled;
-    networkObj["mdnsName"] = network.mdnsName;
+    if (sections.includes("network")) {
+        JsonObject networkObj = doc["network"].to<JsonObject>();
+        networkObj["httpPort"] = network.httpPort;
+        networkObj["wsPort"] = network.wsPort;
+        networkObj["mdnsEnabled"] = network.mdnsEnabled;
+        networkObj["mdnsName"] = network.mdnsName;
+        networkObj["maxBodySize"] = network.maxBodySize;
+        networkObj["rateLimit"] = network.rateLimit;
+        networkObj["rateBurst"] = network.rateBurst;
+        networkObj["apiTimeShare"] = network.apiTimeShare;
+    }
 
     // Auth configuration
-    JsonObject authObj = doc["auth"].to<JsonObject>();
-    authObj["pairingEnabled"] = auth.pairingEnabled;
-    authObj["pairingToken"] = auth.pairingToken;
-    JsonArray allowedDevicesArr = authObj["allowedDevices"].to<JsonArray>();
-    for (const String& deviceId : auth.allowedDevices) {
-        allowedDevicesArr.add(deviceId);
+    if (sections.includes("auth")) {
+        JsonObject authObj = doc["auth"].to<JsonObject>();
+        authObj["pairingEnabled"] = auth.pairingEnabled;
+        authObj["pairingToken"] = auth.pairingToken;
+        JsonArray allowedDevicesArr = authObj["allowedDevices"].to<JsonArray>();
+        for (const String& deviceId : auth.allowedDevices) {
+            allowedDevicesArr.add(deviceId);
+        }
     }
 
     // Device settings
-    JsonObject settingsObj = doc["device_config"].to<JsonObject>();
-    settingsObj["updateInterval"] = deviceSettings.updateInterval;
-    settingsObj["sensorPollingRate"] = deviceSettings.sensorPollingRate;
-
-    String jsonStr;
-    serializeJsonPretty(doc, jsonStr);
-    return jsonStr;
+    if (sections.includes("device_config")) {
+        JsonObject settingsObj = doc["device_config"].to<JsonObject>();
+        settingsObj["updateInterval"] = deviceSettings.updateInterval;
+        settingsObj["sensorPollingRate"] = deviceSettings.sensorPollingRate;
+    }
 }
 
 bool DeviceConfig::fromJSON(const String& json) {
@@ -158,6 +176,10 @@ bool DeviceConfig::fromJSON(const String& json) {
         return false;
     }
 
+    return fromJSON(doc);
+}
+
+bool DeviceConfig::fromJSON(JsonDocument& doc) {
     // Device information
     if (!doc["device"].isNull()) {
         JsonObject deviceObj = doc["device"];
@@ -189,6 +211,10 @@ bool DeviceConfig::fromJSON(const String& json) {
         network.wsPort = networkObj["wsPort"] | 81;
         network.mdnsEnabled = networkObj["mdnsEnabled"] | true;
         network.mdnsName = networkObj["mdnsName"] | "";
+        network.maxBodySize = constrain(networkObj["maxBodySize"] | 2048, 256, 16384);
+        network.rateLimit = constrain(networkObj["rateLimit"] | 10, 0, 1000);
+        network.rateBurst = constrain(networkObj["rateBurst"] | 20, 1, 1000);
+        network.apiTimeShare = constrain(networkObj["apiTimeShare"] | 30, 5, 100);
     }
 
     // Auth configuration
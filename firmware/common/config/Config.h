@@ -10,6 +10,8 @@
 #include <Arduino.h>
 #include <IPAddress.h>
 #include <vector>
+#include <ArduinoJson.h>
+#include "../utils/FieldList.h"
 
 class DeviceConfig {
 public:
@@ -53,8 +55,13 @@ public:
         uint16_t wsPort;        // WebSocket server port
         bool mdnsEnabled;       // Enable mDNS discovery
         String mdnsName;        // mDNS hostname
+        uint16_t maxBodySize;   // Largest accepted HTTP request body (bytes)
+        uint16_t rateLimit;     // API requests per second per client IP (0 = unlimited)
+        uint16_t rateBurst;     // Requests a client may make back to back
+        uint8_t apiTimeShare;   // Percent of device time API requests may use (100 = unlimited)
 
-        Network() : httpPort(80), wsPort(81), mdnsEnabled(true) {}
+        Network() : httpPort(80), wsPort(81), mdnsEnabled(true), maxBodySize(2048),
+                    rateLimit(10), rateBurst(20), apiTimeShare(30) {}
     };
 
     // Authentication configuration
@@ -87,7 +94,9 @@ public:
     bool save();                  // Save to SPIFFS
     void reset();                 // Factory reset to defaults
     String toJSON() const;        // Serialize to JSON
+    void toJSON(JsonDocument& doc, const FieldList& sections = FieldList()) const; // Fill a document (selected sections only)
     bool fromJSON(const String& json); // Deserialize from JSON
+    bool fromJSON(JsonDocument& doc);  // Apply an already parsed document
 
 private:
     static const char* CONFIG_FILE;
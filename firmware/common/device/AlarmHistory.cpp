@@ -0,0 +1,156 @@
+/**
+ * AlarmHistory.cpp
+ * Alarm log implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "AlarmHistory.h"
+#include "../utils/SeqPage.h"
+
+namespace {
+    enum Part : uint8_t {
+        PART_RECORDS,
+        PART_FOOTER,
+        PART_DONE
+    };
+}
+
+AlarmHistory::AlarmHistory()
+    : latest(0), count(0) {
+}
+
+uint32_t AlarmHistory::append(uint8_t type, uint8_t severity, const char* message,
+                              float currentValue, float threshold) {
+    Record record;
+    record.type = type;
+    record.severity = severity;
+    record.acknowledged = false;
+    record.message = message;
+    record.timestamp = millis() / 1000;
+    record.clearedAt = 0;
+    record.currentValue = currentValue;
+    record.threshold = threshold;
+
+    CriticalSection lock(mux);
+    record.seq = latest + 1;
+    records[(record.seq - 1) % ALARM_HISTORY_SIZE] = record;
+    latest = record.seq;
+    if (count < ALARM_HISTORY_SIZE) {
+        count++;
+    }
+    return record.seq;
+}
+
+void AlarmHistory::markCleared(uint32_t seq) {
+    uint32_t now = millis() / 1000;
+    CriticalSection lock(mux);
+    Record* record = slot(seq);
+    if (record) {
+        // 0 means active, so an alarm cleared in the first second reads as 1
+        record->clearedAt = now > 0 ? now : 1;
+    }
+}
+
+void AlarmHistory::markAcknowledged(uint32_t seq) {
+    CriticalSection lock(mux);
+    Record* record = slot(seq);
+    if (record) {
+        record->acknowledged = true;
+    }
+}
+
+void AlarmHistory::reset() {
+    // Sequence numbers keep counting, so old cursors stay meaningful
+    CriticalSection lock(mux);
+    count = 0;
+}
+
+bool AlarmHistory::read(uint32_t seq, Record& out) const {
+    CriticalSection lock(mux);
+    const Record* record = slot(seq);
+    if (!record) {
+        return false;
+    }
+    out = *record;
+    return true;
+}
+
+uint32_t AlarmHistory::getLatestSeq() const {
+    CriticalSection lock(mux);
+    return latest;
+}
+
+uint32_t AlarmHistory::getOldestSeq() const {
+    CriticalSection lock(mux);
+    return count > 0 ? latest - count + 1 : 0;
+}
+
+AlarmHistory::Record* AlarmHistory::slot(uint32_t seq) {
+    if (seq == 0 || seq > latest || latest - seq >= count) {
+        return nullptr;
+    }
+    return &records[(seq - 1) % ALARM_HISTORY_SIZE];
+}
+
+const AlarmHistory::Record* AlarmHistory::slot(uint32_t seq) const {
+    return const_cast<AlarmHistory*>(this)->slot(seq);
+}
+
+AlarmHistory::Exporter::Exporter(const AlarmHistory& h, uint32_t after, uint8_t limit)
+    : history(h), part(PART_RECORDS), firstRecord(true) {
+
+    uint32_t newest;
+    SeqPage page;
+    {
+        CriticalSection lock(history.mux);
+        newest = history.latest;
+        page = SeqPage::after(after, limit, history.latest, history.count);
+    }
+    seq = page.first;
+    last = page.last;
+
+    // The header fits text[] easily; records follow one per piece
+    setPiece(snprintf(text, sizeof(text),
+                      "{\"after\":%lu,\"next\":%lu,\"latest\":%lu,\"more\":%s,\"truncated\":%s,\"history\":[",
+                      (unsigned long)page.since, (unsigned long)page.next, (unsigned long)newest,
+                      page.next < newest ? "true" : "false", page.truncated ? "true" : "false"));
+}
+
+bool AlarmHistory::Exporter::nextPiece() {
+    while (part == PART_RECORDS) {
+        if (seq > last) {
+            part = PART_FOOTER;
+            break;
+        }
+
+        // Overwritten since the page was sized (a burst of alarms); skip it
+        Record record;
+        if (!history.read(seq++, record)) {
+            continue;
+        }
+
+        int len = snprintf(text, sizeof(text),
+                           "%s{\"seq\":%lu,\"type\":%u,\"severity\":%u,\"message\":\"%s\",\"timestamp\":%lu,"
+                           "\"active\":%s,\"clearedAt\":%lu,\"acknowledged\":%s,"
+                           "\"currentValue\":%.2f,\"threshold\":%.2f}",
+                           firstRecord ? "" : ",", (unsigned long)record.seq, record.type, record.severity,
+                           record.message, (unsigned long)record.timestamp,
+                           record.clearedAt == 0 ? "true" : "false", (unsigned long)record.clearedAt,
+                           record.acknowledged ? "true" : "false",
+                           record.currentValue, record.threshold);
+        if (!setPiece(len)) {
+            continue;
+        }
+        firstRecord = false;
+        return true;
+    }
+
+    if (part == PART_FOOTER) {
+        part = PART_DONE;
+        memcpy(text, "]}", 2);
+        textLen = 2;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,88 @@
+/**
+ * AlarmHistory.h
+ * Fixed-size alarm log with sequence numbers for cursor reads
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef ALARM_HISTORY_H
+#define ALARM_HISTORY_H
+
+#include <Arduino.h>
+#include "../utils/ChunkedText.h"
+#include "../utils/CriticalSection.h"
+
+// Alarms kept; the oldest is overwritten when full
+#ifndef ALARM_HISTORY_SIZE
+#define ALARM_HISTORY_SIZE 64
+#endif
+
+// Records returned by one history page
+#ifndef ALARM_HISTORY_PAGE_MAX
+#define ALARM_HISTORY_PAGE_MAX 32
+#endif
+
+/**
+ * Every raised alarm gets the next sequence number and a slot in a ring.
+ * The control loop writes; the network tasks copy single records out, so a
+ * reader never holds the lock for longer than one small memcpy and nothing
+ * is allocated. Sequence numbers are never reused, which makes "everything
+ * after seq N" a stable cursor across wrap-around.
+ */
+class AlarmHistory {
+public:
+    struct Record {
+        uint32_t seq;           // 1, 2, ... in the order alarms were raised
+        uint8_t type;
+        uint8_t severity;
+        bool acknowledged;
+        const char* message;    // Static string, never needs JSON escaping
+        uint32_t timestamp;     // Seconds since boot when raised
+        uint32_t clearedAt;     // Seconds since boot when cleared, 0 while active
+        float currentValue;
+        float threshold;
+    };
+
+    AlarmHistory();
+
+    // Writer (control loop)
+    uint32_t append(uint8_t type, uint8_t severity, const char* message,
+                    float currentValue, float threshold);
+    void markCleared(uint32_t seq);
+    void markAcknowledged(uint32_t seq);
+    void reset();
+
+    // Readers (any task)
+    bool read(uint32_t seq, Record& out) const;     // false once overwritten
+    uint32_t getLatestSeq() const;                   // 0 if nothing was ever raised
+    uint32_t getOldestSeq() const;                   // Oldest still kept, 0 if empty
+
+    /**
+     * Renders one page, {"after":..,"next":..,"history":[..]}, in pieces small
+     * enough for a chunked response, copying one record at a time.
+     */
+    class Exporter : public ChunkedText<256> {
+    public:
+        Exporter(const AlarmHistory& history, uint32_t after, uint8_t limit);
+
+    private:
+        const AlarmHistory& history;
+        uint32_t seq;           // Next record to render
+        uint32_t last;          // Last record of the page
+        uint8_t part;           // Header, records, footer, done
+        bool firstRecord;
+
+        bool nextPiece() override;
+    };
+
+private:
+    Record records[ALARM_HISTORY_SIZE];
+    uint32_t latest;            // Seq of the newest record
+    uint32_t count;             // Records kept, up to ALARM_HISTORY_SIZE
+    mutable CriticalMutex mux = CRITICAL_MUTEX_INIT;
+
+    // Slot of seq if it is still kept, else nullptr; call with mux held
+    Record* slot(uint32_t seq);
+    const Record* slot(uint32_t seq) const;
+};
+
+#endif // ALARM_HISTORY_H
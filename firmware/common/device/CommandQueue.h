@@ -0,0 +1,119 @@
+/**
+ * CommandQueue.h
+ * Hands device commands from the network handlers to the control loop
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../utils/SpscRing.h"
+
+// Commands (and results) each producer can have in flight; power of two
+#ifndef COMMAND_QUEUE_DEPTH
+#define COMMAND_QUEUE_DEPTH 4
+#endif
+
+// Operations one BATCH command may carry; all of them run in a single control tick
+#ifndef BATCH_MAX_OPERATIONS
+#define BATCH_MAX_OPERATIONS 8
+#endif
+
+struct DeviceCommand {
+    enum Type : uint8_t {
+        START = 0,
+        STOP = 1,
+        PAUSE = 2,
+        RESUME = 3,
+        SETPOINT = 4,
+        TEST = 5,
+        BATCH = 6,
+        ACK_ALARM = 7,
+        ACK_ALL_ALARMS = 8,
+        DEVICE = 9          // Operation registered by the device subclass, by code
+    };
+
+    Type type = STOP;
+    uint32_t id = 0;        // Assigned by the producer, echoed in the result
+    uint8_t zone = 0;       // SETPOINT, or the active alarm index of ACK_ALARM
+    uint8_t code = 0;       // DEVICE
+    float value = 0.0f;     // SETPOINT
+    JsonDocument params;    // START / TEST / DEVICE, or the operations array of a BATCH
+    bool wrapped = false;   // params is a whole WebSocket message; the arguments are its "params"
+
+    // Arguments for START / TEST / DEVICE. A WebSocket message is moved in
+    // whole rather than copying its "params" member into a new document.
+    JsonVariantConst arguments() const {
+        return wrapped ? params["params"] : params.as<JsonVariantConst>();
+    }
+
+    // Single command named in a batch operation ("start" ... "test"); false if unknown
+    static bool typeFromName(const char* name, Type& type) {
+        static const char* const NAMES[] = { "start", "stop", "pause", "resume", "setpoint", "test" };
+        for (uint8_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++) {
+            if (name && strcmp(name, NAMES[i]) == 0) {
+                type = (Type)i;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct CommandResult {
+    uint32_t id = 0;
+    DeviceCommand::Type type = DeviceCommand::STOP;
+    bool success = false;
+    JsonDocument data;      // BATCH: per-operation results
+};
+
+/**
+ * One lane per producer, each a pair of SPSC rings: commands flow from the
+ * producer to the device loop, results flow back. The device loop is the
+ * only consumer of commands and the only producer of results, so nothing
+ * on the control path takes a lock.
+ */
+class CommandQueue {
+public:
+    enum Lane : uint8_t {
+        LANE_HTTP = 0,        // AsyncTCP task (ESP32) / sys context (ESP8266)
+        LANE_WEBSOCKET = 1,   // Arduino loop task
+        LANE_COUNT = 2
+    };
+
+    // Producer: queue a command (params are moved out); false when the lane is full
+    bool submit(Lane lane, DeviceCommand& command) {
+        return lanes[lane].commands.push(command);
+    }
+
+    // Producer: collect a finished command; false when none are ready
+    bool takeResult(Lane lane, CommandResult& result) {
+        return lanes[lane].results.pop(result);
+    }
+
+    // Device loop: next command to run. Holds back while the lane's results
+    // are not being collected, so a result never has to be dropped.
+    bool next(Lane lane, DeviceCommand& command) {
+        if (lanes[lane].results.full()) {
+            return false;
+        }
+        return lanes[lane].commands.pop(command);
+    }
+
+    // Device loop: report the outcome of a command returned by next()
+    void complete(Lane lane, CommandResult& result) {
+        lanes[lane].results.push(result);
+    }
+
+private:
+    struct LaneRings {
+        SpscRing<DeviceCommand, COMMAND_QUEUE_DEPTH> commands;
+        SpscRing<CommandResult, COMMAND_QUEUE_DEPTH> results;
+    };
+
+    LaneRings lanes[LANE_COUNT];
+};
+
+#endif // COMMAND_QUEUE_H
@@ -0,0 +1,60 @@
+/**
+ * CommandRegistry.cpp
+ * Command registry implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "CommandRegistry.h"
+#include "../utils/Logger.h"
+
+constexpr uint8_t CommandRegistry::NOT_FOUND;
+
+CommandRegistry::CommandRegistry()
+    : count(0) {
+    memset(slots, NOT_FOUND, sizeof(slots));
+}
+
+bool CommandRegistry::add(const Command* table, size_t tableCount) {
+    bool complete = true;
+
+    for (size_t i = 0; i < tableCount; i++) {
+        const Command& command = table[i];
+
+        if (find(command.name, strlen(command.name)) != NOT_FOUND) {
+            Logger::warning("CommandRegistry: Duplicate command " + String(command.name));
+            complete = false;
+            continue;
+        }
+        if (count >= COMMAND_REGISTRY_MAX) {
+            Logger::warning("CommandRegistry: Full, dropping " + String(command.name));
+            complete = false;
+            continue;
+        }
+
+        // At most half the slots are used, so an empty one is always found
+        uint16_t slot = home(command.key);
+        while (slots[slot] != NOT_FOUND) {
+            slot = (slot + 1) & (COMMAND_REGISTRY_SLOTS - 1);
+        }
+        slots[slot] = count;
+        commands[count++] = &command;
+    }
+
+    return complete;
+}
+
+uint8_t CommandRegistry::find(const char* name, size_t len) const {
+    if (!name) {
+        return NOT_FOUND;
+    }
+
+    uint32_t key = Hash::fnv1aN(name, len);
+    for (uint16_t slot = home(key); slots[slot] != NOT_FOUND;
+         slot = (slot + 1) & (COMMAND_REGISTRY_SLOTS - 1)) {
+        const Command& command = *commands[slots[slot]];
+        if (command.key == key && strncmp(command.name, name, len) == 0 && command.name[len] == '\0') {
+            return slots[slot];
+        }
+    }
+    return NOT_FOUND;
+}
@@ -0,0 +1,85 @@
+/**
+ * CommandRegistry.h
+ * Command names accepted over WebSocket, looked up by hash
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef COMMAND_REGISTRY_H
+#define COMMAND_REGISTRY_H
+
+#include <Arduino.h>
+#include "CommandQueue.h"
+#include "../utils/Hash.h"
+
+// Commands that can be registered (built-ins plus the device's own)
+#ifndef COMMAND_REGISTRY_MAX
+#define COMMAND_REGISTRY_MAX 24
+#endif
+
+// Hash slots; a power of two, kept at least twice COMMAND_REGISTRY_MAX so probes stay short
+#ifndef COMMAND_REGISTRY_SLOTS
+#define COMMAND_REGISTRY_SLOTS 64
+#endif
+
+// Entry for a constexpr command table; the name is hashed at compile time
+#define COMMAND(name, type, code, flags) \
+    { Hash::fnv1a(name), name, type, code, flags }
+
+/**
+ * Entries point into static tables supplied by the network server and the
+ * device subclass; they are registered once at startup and never removed.
+ * Lookup hashes the name once, probes an open-addressed slot array and
+ * confirms with a key compare and a strcmp.
+ */
+class CommandRegistry {
+public:
+    enum Flags : uint8_t {
+        PARAMS = 0x01,          // Takes the message's "params" object
+        REQUIRES_PARAMS = 0x02, // Rejected without "params"
+        LONG_RUNNING = 0x04,    // Answered "accepted" at once; the result follows as a completion event
+        LOCAL = 0x08            // Answered by the network task; never queued to the device
+    };
+
+    struct Command {
+        uint32_t key;               // Hash::fnv1a(name)
+        const char* name;
+        DeviceCommand::Type type;
+        uint8_t code;               // Operation passed to runCommand() for DeviceCommand::DEVICE
+        uint8_t flags;
+    };
+
+    static constexpr uint8_t NOT_FOUND = 0xFF;
+
+    CommandRegistry();
+
+    // Register count entries of a static table; returns false if any were
+    // left out (registry full or name already taken)
+    bool add(const Command* table, size_t count);
+
+    // Index of the named command (len bytes), or NOT_FOUND
+    uint8_t find(const char* name, size_t len) const;
+
+    // Registered commands in registration order
+    uint8_t size() const {
+        return count;
+    }
+    const Command& at(uint8_t index) const {
+        return *commands[index];
+    }
+
+private:
+    static_assert(COMMAND_REGISTRY_SLOTS >= 2 * COMMAND_REGISTRY_MAX, "Too few registry slots");
+    static_assert((COMMAND_REGISTRY_SLOTS & (COMMAND_REGISTRY_SLOTS - 1)) == 0,
+                  "COMMAND_REGISTRY_SLOTS must be a power of two");
+    static_assert(COMMAND_REGISTRY_MAX < NOT_FOUND, "Too many commands for an 8-bit index");
+
+    const Command* commands[COMMAND_REGISTRY_MAX];
+    uint8_t slots[COMMAND_REGISTRY_SLOTS];      // Index into commands, NOT_FOUND if empty
+    uint8_t count;
+
+    static uint16_t home(uint32_t key) {
+        return Hash::fmix(key) & (COMMAND_REGISTRY_SLOTS - 1);
+    }
+};
+
+#endif // COMMAND_REGISTRY_H
@@ -9,6 +9,10 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "StatusSnapshot.h"
+#include "CommandQueue.h"
+#include "CommandRegistry.h"
+#include "AlarmHistory.h"
 
 class DeviceBase {
 public:
@@ -28,7 +32,7 @@ public:
     virtual void begin() = 0;
     virtual void loop() = 0;
     virtual JsonDocument getStatus() = 0;
-    virtual bool start(JsonDocument& params) = 0;
+    virtual bool start(JsonVariantConst params) = 0;
     virtual bool stop() = 0;
     virtual bool pause() = 0;
     virtual bool resume() = 0;
@@ -37,7 +41,41 @@ public:
     // Optional: device-specific diagnostic/test commands
     // Override in device subclass to handle (e.g. "fan", "heater")
     // Returns false if command is unsupported
-    virtual bool runTest(JsonDocument& params) { return false; }
+    virtual bool runTest(JsonVariantConst params) { return false; }
+
+    // Optional: alarms (incubator). Acknowledging returns false if unsupported
+    // or there is no such active alarm; the history is nullptr without alarms.
+    virtual bool acknowledgeAlarm(uint8_t index) { return false; }
+    virtual bool acknowledgeAllAlarms() { return false; }
+    virtual const AlarmHistory* getAlarmHistory() const { return nullptr; }
+
+    // Optional: true while a controlled value is still approaching its
+    // setpoint (ramping, or outside its tolerance band). Telemetry is sent
+    // faster while settling, and slows down once everything holds steady.
+    virtual bool isSettling() const { return false; }
+
+    // Optional: commands beyond start/stop/pause/resume/setpoint/test, added to
+    // the registry once at startup. Entries of type DeviceCommand::DEVICE run
+    // through runCommand() with their code; returns false if it failed.
+    virtual void registerCommands(CommandRegistry& registry) {}
+    virtual bool runCommand(uint8_t code, JsonVariantConst params) { return false; }
+
+    // Optional: vet a command's arguments before it is queued, so bad values
+    // are refused up front instead of failing on the control loop. zone and
+    // value are a SETPOINT's, params the rest. Runs on the network task and
+    // must only look at its arguments. Returns why they are rejected, or
+    // nullptr if they are acceptable.
+    virtual const char* checkParams(DeviceCommand::Type type, uint8_t code, uint8_t zone, float value,
+                                    JsonVariantConst params) const {
+        return nullptr;
+    }
+
+    // Optional: false if an operation cannot run in the given state for
+    // device reasons (a test that needs the device idle). Batches ask this
+    // for each operation, in the state the ones before it leave.
+    virtual bool allowedIn(State state, DeviceCommand::Type type, JsonVariantConst params) const {
+        return true;
+    }
 
     // Common functionality
     State getState() const {
@@ -61,11 +99,61 @@ public:
         return (millis() - startTime) / 1000; // Return uptime in seconds
     }
 
+    // Status as of the last control tick; use this instead of getStatus()
+    // outside the device loop
+    const StatusSnapshot& getStatusSnapshot() const {
+        return statusSnapshot;
+    }
+
+    // Network handlers submit control commands here instead of calling
+    // start()/stop()/... directly; they run on the next control tick
+    CommandQueue& getCommandQueue() {
+        return commandQueue;
+    }
+
 protected:
     State state = IDLE;
     unsigned long startTime = 0;
+    StatusSnapshot statusSnapshot;
+    CommandQueue commandQueue;
+    uint32_t transitions = 0;   // State changes plus whatever markTransition() reported
+
+    // Call at the end of every control tick
+    void publishStatus() {
+        StatusSnapshot::Activity activity;
+        activity.transitions = transitions;
+        activity.settling = isSettling();
+        statusSnapshot.publish(getStatus(), activity);
+    }
+
+    // Report a phase or stage change, or an alarm raised or cleared
+    void markTransition() {
+        transitions++;
+    }
+
+    // Call at the start of every control tick
+    void processCommands() {
+        DeviceCommand command;
+        for (uint8_t i = 0; i < CommandQueue::LANE_COUNT; i++) {
+            CommandQueue::Lane lane = (CommandQueue::Lane)i;
+            while (commandQueue.next(lane, command)) {
+                CommandResult result;
+                result.id = command.id;
+                result.type = command.type;
+                if (command.type == DeviceCommand::BATCH) {
+                    result.success = executeBatch(command.params.as<JsonArrayConst>(), result.data);
+                } else {
+                    result.success = execute(command);
+                }
+                commandQueue.complete(lane, result);
+            }
+        }
+    }
 
     void setState(State newState) {
+        if (newState != state) {
+            markTransition();
+        }
         state = newState;
         if (newState == RUNNING && startTime == 0) {
             startTime = millis();
@@ -73,6 +161,100 @@ protected:
             startTime = 0;
         }
     }
+
+private:
+    bool execute(DeviceCommand& command) {
+        switch (command.type) {
+            case DeviceCommand::START:          return start(command.arguments());
+            case DeviceCommand::STOP:           return stop();
+            case DeviceCommand::PAUSE:          return pause();
+            case DeviceCommand::RESUME:         return resume();
+            case DeviceCommand::SETPOINT:       return setSetpoint(command.zone, command.value);
+            case DeviceCommand::TEST:           return runTest(command.arguments());
+            case DeviceCommand::ACK_ALARM:      return acknowledgeAlarm(command.zone);
+            case DeviceCommand::ACK_ALL_ALARMS: return acknowledgeAllAlarms();
+            case DeviceCommand::DEVICE:         return runCommand(command.code, command.arguments());
+            default:                            return false;
+        }
+    }
+
+    // State an operation moves the device to, or false if it cannot run in
+    // `from`. Covers the lifecycle rules every device shares; allowedIn()
+    // adds the device's own.
+    static bool stateAfter(DeviceCommand::Type type, State from, State& to) {
+        switch (type) {
+            case DeviceCommand::START:  to = RUNNING; return true;
+            case DeviceCommand::STOP:   to = IDLE;    return true;
+            case DeviceCommand::PAUSE:  to = PAUSED;  return from == RUNNING;
+            case DeviceCommand::RESUME: to = RUNNING; return from == PAUSED;
+            default:                    to = from;    return true;
+        }
+    }
+
+    // Index of the first operation that cannot run, walking the list from the
+    // current state, or -1 if they all can
+    int findBlockedOperation(JsonArrayConst operations) const {
+        State simulated = state;
+        int index = 0;
+        for (JsonObjectConst operation : operations) {
+            DeviceCommand::Type type;
+            if (DeviceCommand::typeFromName(operation["op"].as<const char*>(), type) &&
+                (!allowedIn(simulated, type, operation["params"]) || !stateAfter(type, simulated, simulated))) {
+                return index;
+            }
+            index++;
+        }
+        return -1;
+    }
+
+    // Run a validated operation list back to back, with nothing else in between.
+    // Arguments were vetted with checkParams() before the batch was queued, and
+    // a list that breaks the lifecycle or device state rules anywhere is
+    // rejected here before anything runs. What can still fail midway is the
+    // hardware; it stops at that operation, the ones before it stay applied
+    // and the remaining ones are reported as skipped.
+    bool executeBatch(JsonArrayConst operations, JsonDocument& data) {
+        JsonArray results = data["results"].to<JsonArray>();
+        int blocked = findBlockedOperation(operations);
+        bool success = blocked < 0;
+
+        int index = 0;
+        for (JsonObjectConst operation : operations) {
+            const char* name = operation["op"];
+            JsonObject result = results.add<JsonObject>();
+            result["op"] = name;
+
+            if (index++ == blocked) {
+                result["success"] = false;
+                result["error"] = "Not allowed in this state";
+                continue;
+            }
+
+            if (!success) {
+                result["skipped"] = true;
+                continue;
+            }
+
+            if (strcmp(name, "get_status") == 0) {
+                // Reflects the operations before it, unlike the published snapshot
+                result["success"] = true;
+                result["status"] = getStatus();
+                continue;
+            }
+
+            DeviceCommand command;
+            DeviceCommand::typeFromName(name, command.type);
+            command.zone = operation["zone"] | 0;
+            command.value = operation["temperature"] | 0.0f;
+            command.params = operation["params"];
+
+            success = execute(command);
+            result["success"] = success;
+        }
+
+        data["success"] = success;
+        return success;
+    }
 };
 
 #endif // DEVICE_BASE_H
@@ -104,6 +104,18 @@ public:
         return ESP.getFreeHeap();
     }
 
+    /**
+     * Get the largest contiguous free heap block
+     * @return Largest allocatable block in bytes
+     */
+    static uint32_t getMaxFreeBlock() {
+#ifdef ESP32
+        return ESP.getMaxAllocHeap();
+#else
+        return ESP.getMaxFreeBlockSize();
+#endif
+    }
+
     /**
      * Get total heap size
      * @return Total heap in bytes
@@ -0,0 +1,148 @@
+/**
+ * StatusSnapshot.cpp
+ * Versioned status snapshot implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "StatusSnapshot.h"
+
+StatusSnapshot::StatusSnapshot()
+    : version(0), activity(), msgpackWanted(false) {
+}
+
+bool StatusSnapshot::publish(const JsonDocument& status, const Activity& latest) {
+    {
+        CriticalSection lock(mux);
+        activity = latest;
+    }
+
+    // Serialize into a reused buffer so an unchanged status costs no allocation
+    uint32_t startedAt = micros();
+    scratch = "";
+    serializeJson(status, scratch);
+    uint32_t jsonMicros = micros() - startedAt;
+
+    // Only the publisher writes, so the current frame can be read unlocked here.
+    // An unchanged status is republished (same version) only to add MessagePack.
+    bool changed = !current || current->json != scratch;
+    bool addMsgPack = msgpackWanted && current && current->msgpack.empty();
+    if (!changed && !addMsgPack) {
+        return false;
+    }
+
+    std::shared_ptr<Frame> next = std::make_shared<Frame>();
+    next->version = changed ? version + 1 : version;
+    next->json = scratch;
+    next->jsonMicros = jsonMicros;
+    next->memberCount = indexMembers(next->json, next->members, STATUS_SNAPSHOT_MAX_FIELDS);
+
+    next->msgpackMicros = 0;
+    if (msgpackWanted) {
+        startedAt = micros();
+        next->msgpack.resize(measureMsgPack(status));
+        serializeMsgPack(status, next->msgpack.data(), next->msgpack.size());
+        next->msgpackMicros = micros() - startedAt;
+    }
+
+    FramePtr previous;
+    {
+        CriticalSection lock(mux);
+        previous = current;
+        current = next;
+        version = next->version;
+    }
+    // previous is released here, outside the critical section
+    return changed;
+}
+
+uint8_t StatusSnapshot::indexMembers(const String& json, Frame::Member* members, uint8_t max) {
+    // Walk the serialized object once, tracking strings and nesting,
+    // and note where each member of the outer object starts and ends
+    uint8_t count = 0;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    bool inKey = false;
+    bool inMember = false;
+    uint16_t start = 0;
+    uint16_t keyLength = 0;
+
+    const char* s = json.c_str();
+    for (uint16_t i = 0; i < json.length(); i++) {
+        char c = s[i];
+        if (inString) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                inString = false;
+                if (inKey) {
+                    keyLength = i - start - 1;
+                    inKey = false;
+                }
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                inString = true;
+                if (depth == 1 && !inMember) {
+                    start = i;
+                    inKey = true;
+                    inMember = true;
+                }
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case ',':
+            case '}':
+            case ']':
+                if (depth == 1 && inMember) {
+                    if (count < max) {
+                        members[count].start = start;
+                        members[count].keyLength = keyLength;
+                        members[count].length = i - start;
+                        count++;
+                    }
+                    inMember = false;
+                }
+                if (c != ',') depth--;
+                break;
+        }
+    }
+    return count;
+}
+
+void StatusSnapshot::Frame::project(const FieldList& fields, String& out) const {
+    out = "{";
+    for (uint8_t i = 0; i < memberCount; i++) {
+        const Member& member = members[i];
+        if (!fields.includes(json.c_str() + member.start + 1, member.keyLength)) {
+            continue;
+        }
+        if (out.length() > 1) {
+            out += ',';
+        }
+        out.concat(json.c_str() + member.start, member.length);
+    }
+    out += '}';
+}
+
+StatusSnapshot::FramePtr StatusSnapshot::get() const {
+    CriticalSection lock(mux);
+    return current;
+}
+
+uint32_t StatusSnapshot::getVersion() const {
+    CriticalSection lock(mux);
+    return version;
+}
+
+StatusSnapshot::Activity StatusSnapshot::getActivity() const {
+    CriticalSection lock(mux);
+    return activity;
+}
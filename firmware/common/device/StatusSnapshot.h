@@ -0,0 +1,89 @@
+/**
+ * StatusSnapshot.h
+ * Versioned, pre-serialized copy of the device status
+ * Built once per control tick and shared by every status reader
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+#include <vector>
+#include "../utils/CriticalSection.h"
+#include "../utils/FieldList.h"
+
+// Top-level status fields indexed per frame for projection; extra fields are
+// still served in full, just not selectable
+#ifndef STATUS_SNAPSHOT_MAX_FIELDS
+#define STATUS_SNAPSHOT_MAX_FIELDS 40
+#endif
+
+class StatusSnapshot {
+public:
+    // One published status; immutable once handed out
+    struct Frame {
+        uint32_t version;       // Starts at 1, bumped whenever the content changes
+        String json;            // Serialized status document
+        std::vector<uint8_t> msgpack;   // Same document as MessagePack, once a reader wants it
+
+        // Encode cost of this frame, for comparing the two formats
+        uint32_t jsonMicros;
+        uint32_t msgpackMicros;
+
+        // Where each top-level "key":value pair sits in json
+        struct Member {
+            uint16_t start;     // Offset of the key's opening quote
+            uint16_t keyLength; // Key without quotes
+            uint16_t length;    // Whole "key":value text
+        };
+        Member members[STATUS_SNAPSHOT_MAX_FIELDS];
+        uint8_t memberCount;
+
+        // Object with just the selected top-level fields, in status order.
+        // Copies the already serialized values; nothing is rebuilt.
+        void project(const FieldList& fields, String& out) const;
+    };
+
+    typedef std::shared_ptr<const Frame> FramePtr;
+
+    // How fast the process is moving, published with every tick so telemetry
+    // can be paced to it
+    struct Activity {
+        uint32_t transitions;   // Bumped on each state, phase or stage change and alarm transition
+        bool settling;          // A controlled value is still on its way to the setpoint
+    };
+
+    StatusSnapshot();
+
+    // Serialize status and publish it; returns true if the version changed.
+    // The activity is stored even when the status itself is unchanged.
+    bool publish(const JsonDocument& status, const Activity& activity = Activity());
+
+    // Latest frame (nullptr before the first publish). Safe to call from
+    // any task; the frame stays valid for as long as the pointer is held.
+    FramePtr get() const;
+
+    uint32_t getVersion() const;
+    Activity getActivity() const;
+
+    // Ask the publisher to encode MessagePack as well, from the next tick on.
+    // Costs a second serialization per changed status, so it is opt-in.
+    void wantMsgPack() const {
+        msgpackWanted = true;
+    }
+
+private:
+    static uint8_t indexMembers(const String& json, Frame::Member* members, uint8_t max);
+
+    FramePtr current;
+    uint32_t version;
+    Activity activity;
+    String scratch;             // Publisher-side serialization buffer
+    mutable volatile bool msgpackWanted;
+    mutable CriticalMutex mux = CRITICAL_MUTEX_INIT;
+};
+
+#endif // STATUS_SNAPSHOT_H
@@ -0,0 +1,110 @@
+/**
+ * AdmissionControl.cpp
+ * Per-client token buckets and a global time budget implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "AdmissionControl.h"
+#include <climits>
+
+namespace {
+    const uint32_t TOKEN = 1000;    // One request, in bucket units
+
+    uint32_t secondsFor(uint32_t millisecs) {
+        uint32_t seconds = (millisecs + 999) / 1000;
+        return seconds > 0 ? seconds : 1;
+    }
+}
+
+AdmissionControl::AdmissionControl(DeviceConfig& cfg)
+    : config(cfg), budgetMicros(0), budgetRefilledAt(0), rejectedByClient(0), rejectedBusy(0) {
+    memset(clients, 0, sizeof(clients));
+}
+
+AdmissionControl::Verdict AdmissionControl::admit(uint32_t clientIp, uint32_t& retryAfter) {
+    const DeviceConfig::Network& limits = config.network;
+    unsigned long now = millis();
+
+    CriticalSection lock(mux);
+
+    // Whole-device budget first: it protects the control loop from many clients at once
+    if (limits.apiTimeShare < 100) {
+        refillBudget();
+        if (budgetMicros <= 0) {
+            rejectedBusy++;
+            // The budget refills at apiTimeShare percent of real time
+            uint32_t waitMicros = (uint32_t)(-budgetMicros) * 100 / limits.apiTimeShare;
+            retryAfter = secondsFor(waitMicros / 1000);
+            return DEVICE_BUSY;
+        }
+    }
+
+    if (limits.rateLimit == 0) {
+        return ADMITTED;
+    }
+
+    Client& client = clientFor(clientIp, now);
+
+    // rateLimit requests per second is rateLimit tokens per millisecond
+    uint32_t capacity = (uint32_t)limits.rateBurst * TOKEN;
+    uint32_t refill = (now - client.refilledAt) * limits.rateLimit;
+    client.tokens = (refill >= capacity - client.tokens) ? capacity : client.tokens + refill;
+    client.refilledAt = now;
+
+    if (client.tokens < TOKEN) {
+        rejectedByClient++;
+        retryAfter = secondsFor((TOKEN - client.tokens) / limits.rateLimit + 1);
+        return CLIENT_LIMITED;
+    }
+
+    client.tokens -= TOKEN;
+    return ADMITTED;
+}
+
+void AdmissionControl::charge(uint32_t busyMicros) {
+    if (config.network.apiTimeShare >= 100) {
+        return;
+    }
+
+    CriticalSection lock(mux);
+    refillBudget();
+    budgetMicros -= (int32_t)(busyMicros < BUDGET_WINDOW_MICROS ? busyMicros : BUDGET_WINDOW_MICROS);
+}
+
+AdmissionControl::Client& AdmissionControl::clientFor(uint32_t ip, unsigned long now) {
+    // Reuse a free slot, or else the one idle the longest
+    Client* victim = nullptr;
+    unsigned long victimAge = 0;
+    for (uint8_t i = 0; i < ADMISSION_MAX_CLIENTS; i++) {
+        if (clients[i].ip == ip) {
+            return clients[i];
+        }
+        unsigned long age = clients[i].ip == 0 ? ULONG_MAX : now - clients[i].refilledAt;
+        if (!victim || age > victimAge) {
+            victim = &clients[i];
+            victimAge = age;
+        }
+    }
+
+    // New clients start with a full bucket
+    victim->ip = ip;
+    victim->tokens = (uint32_t)config.network.rateBurst * TOKEN;
+    victim->refilledAt = now;
+    return *victim;
+}
+
+void AdmissionControl::refillBudget() {
+    uint32_t now = micros();
+    uint32_t elapsed = now - budgetRefilledAt;
+    budgetRefilledAt = now;
+
+    // The API may use apiTimeShare percent of each window; the rest belongs to the control loop
+    if (elapsed > BUDGET_WINDOW_MICROS) {
+        elapsed = BUDGET_WINDOW_MICROS;
+    }
+    int32_t capacity = (int32_t)(BUDGET_WINDOW_MICROS * config.network.apiTimeShare / 100);
+    budgetMicros += (int32_t)(elapsed * config.network.apiTimeShare / 100);
+    if (budgetMicros > capacity) {
+        budgetMicros = capacity;
+    }
+}
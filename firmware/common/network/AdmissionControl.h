@@ -0,0 +1,63 @@
+/**
+ * AdmissionControl.h
+ * Per-client token buckets and a global time budget for API requests
+ * Keeps request floods from starving the device control loop
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../utils/CriticalSection.h"
+
+// Client addresses tracked at once; the least recently seen one is recycled
+#ifndef ADMISSION_MAX_CLIENTS
+#define ADMISSION_MAX_CLIENTS 8
+#endif
+
+class AdmissionControl {
+public:
+    enum Verdict {
+        ADMITTED = 0,
+        CLIENT_LIMITED,     // Client spent its own budget
+        DEVICE_BUSY         // API used up its share of the device's time
+    };
+
+    // Limits are read from config.network on every check, so changes apply at once
+    explicit AdmissionControl(DeviceConfig& config);
+
+    // Decide whether a request from clientIp may run; retryAfter is set
+    // to the seconds until it would be admitted when it is not
+    Verdict admit(uint32_t clientIp, uint32_t& retryAfter);
+
+    // Account time spent serving an admitted request against the API's share
+    void charge(uint32_t busyMicros);
+
+    uint32_t getRejectedByClient() const { return rejectedByClient; }
+    uint32_t getRejectedBusy() const { return rejectedBusy; }
+
+private:
+    struct Client {
+        uint32_t ip;            // 0 when the slot is free
+        uint32_t tokens;        // Thousandths of a request
+        unsigned long refilledAt;
+    };
+
+    // The API time budget holds at most one control tick's share
+    static const uint32_t BUDGET_WINDOW_MICROS = 100000;
+
+    DeviceConfig& config;
+    Client clients[ADMISSION_MAX_CLIENTS];
+    int32_t budgetMicros;       // Negative after an expensive request
+    uint32_t budgetRefilledAt;  // micros()
+    uint32_t rejectedByClient;
+    uint32_t rejectedBusy;
+    CriticalMutex mux = CRITICAL_MUTEX_INIT;
+
+    Client& clientFor(uint32_t ip, unsigned long now);
+    void refillBudget();
+};
+
+#endif // ADMISSION_CONTROL_H
@@ -0,0 +1,315 @@
+/**
+ * ApiMetrics.cpp
+ * Per-endpoint request metrics implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "ApiMetrics.h"
+#include "../utils/Logger.h"
+
+namespace {
+    // Smallest bucket bound; each following bucket doubles it
+    const uint32_t FIRST_BUCKET_MICROS = 512;
+
+    enum Family : uint8_t {
+        FAMILY_REQUESTS = 0,
+        FAMILY_ERRORS = 1,
+        FAMILY_BYTES = 2,
+        FAMILY_LATENCY = 3,
+        FAMILY_QUEUE_DEPTH = 4,
+        FAMILY_QUEUE_BYTES = 5,
+        FAMILY_DROPS = 6,
+        FAMILY_COUNT = 7
+    };
+
+    const char* const FAMILY_HEADERS[FAMILY_COUNT] = {
+        "# HELP axionyx_api_requests_total Requests handled per endpoint\n"
+        "# TYPE axionyx_api_requests_total counter\n",
+        "# HELP axionyx_api_errors_total Requests answered with an error per endpoint\n"
+        "# TYPE axionyx_api_errors_total counter\n",
+        "# HELP axionyx_api_response_bytes_total Response body bytes sent per endpoint\n"
+        "# TYPE axionyx_api_response_bytes_total counter\n",
+        "# HELP axionyx_api_latency_seconds Time from request to response per endpoint\n"
+        "# TYPE axionyx_api_latency_seconds histogram\n",
+        "# HELP axionyx_ws_client_queue_depth Messages waiting for a slow WebSocket client\n"
+        "# TYPE axionyx_ws_client_queue_depth gauge\n",
+        "# HELP axionyx_ws_client_queue_bytes Bytes waiting for a slow WebSocket client\n"
+        "# TYPE axionyx_ws_client_queue_bytes gauge\n",
+        "# HELP axionyx_ws_client_drops_total WebSocket clients disconnected for falling behind\n"
+        "# TYPE axionyx_ws_client_drops_total counter\n"
+    };
+}
+
+ApiMetrics::ApiMetrics()
+    : endpointCount(0) {
+    memset(endpoints, 0, sizeof(endpoints));
+    memset(traces, 0, sizeof(traces));
+    memset(clientQueues, 0, sizeof(clientQueues));
+    memset(clientDrops, 0, sizeof(clientDrops));
+}
+
+ApiMetrics::Endpoint ApiMetrics::add(const char* transport, const char* method, const char* name) {
+    if (endpointCount >= API_METRICS_MAX_ENDPOINTS) {
+        Logger::warning("ApiMetrics: Endpoint table full, not tracking " + String(name));
+        return NO_ENDPOINT;
+    }
+
+    Counters& counters = endpoints[endpointCount];
+    counters.transport = transport;
+    counters.method = method;
+    counters.name = name;
+    return endpointCount++;
+}
+
+void ApiMetrics::record(Endpoint endpoint, bool error, size_t bytesOut, uint32_t latencyMicros) {
+    if (endpoint >= endpointCount) {
+        return;
+    }
+
+    uint8_t bucket = bucketFor(latencyMicros);
+
+    CriticalSection lock(mux);
+    Counters& counters = endpoints[endpoint];
+    counters.requests++;
+    if (error) counters.errors++;
+    counters.bytesOut += bytesOut;
+    counters.latencySumMicros += latencyMicros;
+    counters.latency[bucket]++;
+}
+
+void ApiMetrics::begin(const void* request, Endpoint endpoint) {
+    if (endpoint >= endpointCount) {
+        return;
+    }
+
+    uint32_t now = micros();
+
+    CriticalSection lock(mux);
+    Trace* trace = findTrace(nullptr);
+    if (trace) {
+        trace->request = request;
+        trace->endpoint = endpoint;
+        trace->startedAt = now;
+    }
+}
+
+void ApiMetrics::end(const void* request, int statusCode, size_t bytesOut) {
+    Endpoint endpoint;
+    uint32_t startedAt;
+    {
+        CriticalSection lock(mux);
+        Trace* trace = findTrace(request);
+        if (!trace) {
+            return;
+        }
+        endpoint = trace->endpoint;
+        startedAt = trace->startedAt;
+        trace->request = nullptr;
+    }
+
+    record(endpoint, statusCode >= 400, bytesOut, micros() - startedAt);
+}
+
+void ApiMetrics::abandon(const void* request) {
+    // The client gave up before getting an answer
+    end(request, 499, 0);
+}
+
+void ApiMetrics::setClientQueue(uint8_t client, bool connected, uint16_t depth, uint32_t bytes) {
+    if (client >= API_METRICS_MAX_WS_CLIENTS) {
+        return;
+    }
+
+    CriticalSection lock(mux);
+    ClientQueue& queue = clientQueues[client];
+    queue.connected = connected;
+    queue.depth = depth;
+    queue.bytes = bytes;
+}
+
+void ApiMetrics::countClientDrop(const char* reason) {
+    CriticalSection lock(mux);
+    for (uint8_t i = 0; i < API_METRICS_MAX_DROP_REASONS; i++) {
+        ClientDrops& drops = clientDrops[i];
+        if (drops.reason == reason || !drops.reason) {
+            drops.reason = reason;
+            drops.count++;
+            return;
+        }
+    }
+}
+
+uint8_t ApiMetrics::bucketFor(uint32_t latencyMicros) {
+    uint8_t bucket = 0;
+    uint32_t bound = FIRST_BUCKET_MICROS;
+    while (bucket < LATENCY_BUCKETS && latencyMicros > bound) {
+        bound <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+ApiMetrics::Trace* ApiMetrics::findTrace(const void* request) {
+    for (uint8_t i = 0; i < API_METRICS_MAX_TRACES; i++) {
+        if (traces[i].request == request) {
+            return &traces[i];
+        }
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Prometheus Exporter
+// ============================================================================
+
+ApiMetrics::Exporter::Exporter(ApiMetrics& m)
+    : metrics(m), family(0), endpoint(0), line(0) {
+}
+
+bool ApiMetrics::Exporter::nextPiece() {
+    while (family < FAMILY_COUNT) {
+        // Family header is emitted as its own piece; it can exceed text[]
+        if (endpoint == 0 && line == 0) {
+            line = 1;
+            const char* header = FAMILY_HEADERS[family];
+            size_t len = strlen(header);
+            if (len >= sizeof(text)) len = sizeof(text) - 1;
+            memcpy(text, header, len);
+            textLen = len;
+            return true;
+        }
+
+        // Per-client families iterate over client slots or drop reasons instead
+        if (family >= FAMILY_QUEUE_DEPTH) {
+            uint8_t slots = family == FAMILY_DROPS ? API_METRICS_MAX_DROP_REASONS : API_METRICS_MAX_WS_CLIENTS;
+            if (endpoint >= slots) {
+                family++;
+                endpoint = 0;
+                line = 0;
+                continue;
+            }
+            int len = clientLine();
+            endpoint++;
+            if (setPiece(len)) {
+                return true;
+            }
+            continue;
+        }
+
+        if (endpoint >= metrics.endpointCount) {
+            family++;
+            endpoint = 0;
+            line = 0;
+            continue;
+        }
+
+        // Copy the counters so a line is consistent even if a request lands meanwhile
+        Counters c;
+        {
+            CriticalSection lock(metrics.mux);
+            c = metrics.endpoints[endpoint];
+        }
+
+        // Series appear once an endpoint has been used, which keeps the scrape small
+        if (c.requests == 0) {
+            endpoint++;
+            continue;
+        }
+
+        char labels[96];
+        snprintf(labels, sizeof(labels), "transport=\"%s\",method=\"%s\",endpoint=\"%s\"",
+                 c.transport, c.method, c.name);
+
+        // line counts from 1 within an endpoint; the latency family has several
+        int len = 0;
+        bool lastLine = true;
+        switch (family) {
+            case FAMILY_REQUESTS:
+                len = snprintf(text, sizeof(text), "axionyx_api_requests_total{%s} %lu\n",
+                               labels, (unsigned long)c.requests);
+                break;
+            case FAMILY_ERRORS:
+                len = snprintf(text, sizeof(text), "axionyx_api_errors_total{%s} %lu\n",
+                               labels, (unsigned long)c.errors);
+                break;
+            case FAMILY_BYTES:
+                len = snprintf(text, sizeof(text), "axionyx_api_response_bytes_total{%s} %lu\n",
+                               labels, (unsigned long)c.bytesOut);
+                break;
+            default: {
+                uint8_t bucket = line - 1;
+                if (bucket <= LATENCY_BUCKETS) {
+                    // Cumulative counts, as Prometheus histograms expect
+                    uint32_t cumulative = 0;
+                    for (uint8_t b = 0; b <= bucket; b++) {
+                        cumulative += c.latency[b];
+                    }
+                    if (bucket < LATENCY_BUCKETS) {
+                        unsigned long bound = FIRST_BUCKET_MICROS << bucket;
+                        len = snprintf(text, sizeof(text),
+                                       "axionyx_api_latency_seconds_bucket{%s,le=\"%lu.%06lu\"} %lu\n",
+                                       labels, bound / 1000000UL, bound % 1000000UL,
+                                       (unsigned long)cumulative);
+                    } else {
+                        len = snprintf(text, sizeof(text),
+                                       "axionyx_api_latency_seconds_bucket{%s,le=\"+Inf\"} %lu\n",
+                                       labels, (unsigned long)cumulative);
+                    }
+                    lastLine = false;
+                } else if (bucket == LATENCY_BUCKETS + 1) {
+                    len = snprintf(text, sizeof(text), "axionyx_api_latency_seconds_sum{%s} %lu.%06lu\n",
+                                   labels, (unsigned long)(c.latencySumMicros / 1000000ULL),
+                                   (unsigned long)(c.latencySumMicros % 1000000ULL));
+                    lastLine = false;
+                } else {
+                    len = snprintf(text, sizeof(text), "axionyx_api_latency_seconds_count{%s} %lu\n",
+                                   labels, (unsigned long)c.requests);
+                }
+                break;
+            }
+        }
+
+        if (lastLine) {
+            endpoint++;
+            line = 1;
+        } else {
+            line++;
+        }
+
+        if (setPiece(len)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int ApiMetrics::Exporter::clientLine() {
+    if (family == FAMILY_DROPS) {
+        ClientDrops drops;
+        {
+            CriticalSection lock(metrics.mux);
+            drops = metrics.clientDrops[endpoint];
+        }
+        if (!drops.reason) {
+            return 0;
+        }
+        return snprintf(text, sizeof(text), "axionyx_ws_client_drops_total{reason=\"%s\"} %lu\n",
+                        drops.reason, (unsigned long)drops.count);
+    }
+
+    ClientQueue queue;
+    {
+        CriticalSection lock(metrics.mux);
+        queue = metrics.clientQueues[endpoint];
+    }
+    if (!queue.connected) {
+        return 0;
+    }
+    if (family == FAMILY_QUEUE_DEPTH) {
+        return snprintf(text, sizeof(text), "axionyx_ws_client_queue_depth{client=\"%u\"} %u\n",
+                        endpoint, queue.depth);
+    }
+    return snprintf(text, sizeof(text), "axionyx_ws_client_queue_bytes{client=\"%u\"} %lu\n",
+                    endpoint, (unsigned long)queue.bytes);
+}
@@ -0,0 +1,128 @@
+/**
+ * ApiMetrics.h
+ * Per-endpoint request counters and latency histograms
+ * Exported in Prometheus text format at GET /api/v1/metrics
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef API_METRICS_H
+#define API_METRICS_H
+
+#include <Arduino.h>
+#include "../utils/ChunkedText.h"
+#include "../utils/CriticalSection.h"
+
+// Endpoints that can be tracked (HTTP routes + WebSocket commands and
+// broadcasts): the incubator registers 42, the PCR 29
+#ifndef API_METRICS_MAX_ENDPOINTS
+#ifdef DEVICE_TYPE_INCUBATOR
+#define API_METRICS_MAX_ENDPOINTS 48
+#else
+#define API_METRICS_MAX_ENDPOINTS 32
+#endif
+#endif
+
+// HTTP requests that can be timed concurrently
+#ifndef API_METRICS_MAX_TRACES
+#define API_METRICS_MAX_TRACES 8
+#endif
+
+// WebSocket client slots with outbound queue gauges, and reasons clients are dropped for
+#ifndef API_METRICS_MAX_WS_CLIENTS
+#define API_METRICS_MAX_WS_CLIENTS 8
+#endif
+#ifndef API_METRICS_MAX_DROP_REASONS
+#define API_METRICS_MAX_DROP_REASONS 4
+#endif
+
+class ApiMetrics {
+public:
+    typedef uint8_t Endpoint;
+    static const Endpoint NO_ENDPOINT = 0xFF;
+
+    // Latency buckets double from 512 us up to ~1 s, plus +Inf
+    static const uint8_t LATENCY_BUCKETS = 12;
+
+    ApiMetrics();
+
+    // Register an endpoint during setup; the strings must outlive the metrics
+    Endpoint add(const char* transport, const char* method, const char* name);
+
+    // The index-th of a run of endpoints registered back to back
+    static Endpoint offset(Endpoint first, uint8_t index) {
+        return first == NO_ENDPOINT ? NO_ENDPOINT : first + index;
+    }
+
+    // Count one handled request
+    void record(Endpoint endpoint, bool error, size_t bytesOut, uint32_t latencyMicros);
+
+    // Time an HTTP request whose response may be sent later, or from
+    // another task; end() records it, abandon() counts it as an error
+    void begin(const void* request, Endpoint endpoint);
+    void end(const void* request, int statusCode, size_t bytesOut);
+    void abandon(const void* request);
+
+    // Messages and bytes waiting for a WebSocket client; a disconnected client has no series
+    void setClientQueue(uint8_t client, bool connected, uint16_t depth, uint32_t bytes);
+    // A WebSocket client dropped for falling behind; reason must outlive the metrics
+    void countClientDrop(const char* reason);
+
+    /**
+     * Renders the exposition a piece at a time, for a chunked response,
+     * so the (tens of KB) text never has to be held in RAM
+     */
+    class Exporter : public ChunkedText<200> {
+    public:
+        explicit Exporter(ApiMetrics& metrics);
+
+    private:
+        ApiMetrics& metrics;
+        uint8_t family;
+        uint8_t endpoint;
+        uint8_t line;
+
+        bool nextPiece() override;     // One line, or a family header
+        int clientLine();
+    };
+
+private:
+    struct Counters {
+        const char* transport;
+        const char* method;
+        const char* name;
+        uint32_t requests;
+        uint32_t errors;
+        uint32_t bytesOut;
+        uint64_t latencySumMicros;
+        uint32_t latency[LATENCY_BUCKETS + 1];   // Last bucket is +Inf
+    };
+
+    struct Trace {
+        const void* request;    // nullptr when free
+        Endpoint endpoint;
+        uint32_t startedAt;     // micros()
+    };
+
+    struct ClientQueue {
+        bool connected;
+        uint16_t depth;
+        uint32_t bytes;
+    };
+
+    struct ClientDrops {
+        const char* reason;     // nullptr when unused
+        uint32_t count;
+    };
+
+    Counters endpoints[API_METRICS_MAX_ENDPOINTS];
+    ClientQueue clientQueues[API_METRICS_MAX_WS_CLIENTS];
+    ClientDrops clientDrops[API_METRICS_MAX_DROP_REASONS];
+    uint8_t endpointCount;
+    Trace traces[API_METRICS_MAX_TRACES];
+    CriticalMutex mux = CRITICAL_MUTEX_INIT;
+
+    static uint8_t bucketFor(uint32_t latencyMicros);
+    Trace* findTrace(const void* request);
+};
+
+#endif // API_METRICS_H
@@ -0,0 +1,88 @@
+/**
+ * FlashAssetHandler.cpp
+ * Serves build-time generated assets straight from flash
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "FlashAssetHandler.h"
+#include "../utils/Logger.h"
+
+FlashAssetHandler::FlashAssetHandler(const char* u, const FlashAsset& a)
+    : uri(u), asset(a) {
+}
+
+bool FlashAssetHandler::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET || request->url() != uri) {
+        return false;
+    }
+
+    // Headers are dropped after routing unless a handler asks to keep them
+    request->addInterestingHeader("If-None-Match");
+    return true;
+}
+
+void FlashAssetHandler::handleRequest(AsyncWebServerRequest* request) {
+    Logger::debug("HTTPServer: GET " + request->url());
+    send(request, asset);
+}
+
+int FlashAssetHandler::send(AsyncWebServerRequest* request, const FlashAsset& asset) {
+    AsyncWebServerResponse* response;
+    int code = 200;
+    if (etagMatches(request, asset.etag)) {
+        code = 304;
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse_P(200, asset.contentType, asset.data, asset.length);
+        if (asset.encoding) {
+            response->addHeader("Content-Encoding", asset.encoding);
+        }
+    }
+
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", asset.cacheControl);
+    request->send(response);
+    return code;
+}
+
+bool FlashAssetHandler::etagMatches(AsyncWebServerRequest* request, const char* etag) {
+    if (!request->hasHeader("If-None-Match")) {
+        return false;
+    }
+
+    const String& value = request->getHeader("If-None-Match")->value();
+    if (value == "*") {
+        return true;
+    }
+
+    // Compare opaque tags only, so "abc", W/"abc" and a bare abc all match
+    const char* tag = etag;
+    size_t tagLen = strlen(tag);
+    if (tagLen >= 2 && tag[0] == '"' && tag[tagLen - 1] == '"') {
+        tag++;
+        tagLen -= 2;
+    }
+
+    // The header may carry a comma-separated list
+    const char* p = value.c_str();
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        if (p[0] == 'W' && p[1] == '/') p += 2;
+
+        const char* end = p;
+        while (*end && *end != ',') end++;
+        const char* last = end;
+        while (last > p && last[-1] == ' ') last--;
+
+        const char* start = p;
+        if (last - start >= 2 && *start == '"' && last[-1] == '"') {
+            start++;
+            last--;
+        }
+        if ((size_t)(last - start) == tagLen && strncmp(start, tag, tagLen) == 0) {
+            return true;
+        }
+        p = end;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+/**
+ * FlashAssetHandler.h
+ * Serves build-time generated assets straight from flash
+ * Answers conditional GETs with 304 when the ETag matches
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef FLASH_ASSET_HANDLER_H
+#define FLASH_ASSET_HANDLER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// Immutable asset compiled into flash (see firmware/scripts/generate_assets.py)
+struct FlashAsset {
+    const char* contentType;
+    const uint8_t* data;      // PROGMEM
+    size_t length;
+    const char* etag;         // Quoted strong ETag
+    const char* encoding;     // Content-Encoding, or nullptr
+    const char* cacheControl; // Cache-Control header value
+};
+
+class FlashAssetHandler : public AsyncWebHandler {
+public:
+    FlashAssetHandler(const char* uri, const FlashAsset& asset);
+
+    bool canHandle(AsyncWebServerRequest* request) override;
+    void handleRequest(AsyncWebServerRequest* request) override;
+
+    // Send asset, or 304 if the client already has this version; returns the status code
+    static int send(AsyncWebServerRequest* request, const FlashAsset& asset);
+
+    // True if an If-None-Match header lists the given ETag (or "*")
+    static bool etagMatches(AsyncWebServerRequest* request, const char* etag);
+
+private:
+    const char* uri;
+    FlashAsset asset;
+};
+
+#endif // FLASH_ASSET_HANDLER_H
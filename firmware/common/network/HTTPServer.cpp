@@ -7,13 +7,34 @@
 #include "HTTPServer.h"
 #include "../utils/Logger.h"
 #include "../device/DeviceIdentity.h"
+#include "../assets/TemplateCatalogs.h"
+#include "../assets/ProvisionPage.h"
+#include "FlashAssetHandler.h"
+#include "RouteTable.h"
 #include <ArduinoJson.h>
 
-HTTPServer::HTTPServer(DeviceConfig& cfg, DeviceBase& dev, WiFiManager& wm)
-    : config(cfg), device(dev), wifi(wm), server(nullptr), serverStarted(false) {
+HTTPServer::HTTPServer(DeviceConfig& cfg, DeviceBase& dev, WiFiManager& wm, DeferredActions& da,
+                       ApiMetrics& am, AdmissionControl& ac)
+    : config(cfg), device(dev), wifi(wm), deferred(da), metrics(am), admission(ac),
+      server(nullptr), serverStarted(false),
+      heapLowWater(UINT32_MAX), metricsBase(ApiMetrics::NO_ENDPOINT), nextCommandId(0),
+      latestTelemetryId(0), streamCount(0), nextStreamSession(0) {
+    for (PendingCommand& slot : pendingCommands) {
+        slot.id = 0;
+        slot.request = nullptr;
+        slot.ready = false;
+    }
+    for (StreamClient& stream : streamClients) {
+        stream.active = false;
+        stream.session = 0;
+        stream.resuming = false;
+        stream.resumeSince = 0;
+        stream.replayNext = 0;
+    }
 }
 
 HTTPServer::~HTTPServer() {
+    // The server owns its handlers
     if (server) {
         delete server;
     }
@@ -22,8 +43,12 @@ HTTPServer::~HTTPServer() {
 void HTTPServer::begin() {
     Logger::info("HTTPServer: Initializing on port " + String(config.network.httpPort));
 
+    bodyPool.begin(HTTP_BODY_POOL_SLOTS, config.network.maxBodySize);
+    heapLowWater = DeviceIdentity::getFreeHeap();
+
     server = new AsyncWebServer(config.network.httpPort);
     setupRoutes();
+    registerMetrics();
 
     Logger::info("HTTPServer: Routes configured, waiting for WiFi to start server");
 }
@@ -37,156 +62,205 @@ void HTTPServer::loop() {
         Logger::info("HTTPServer: Started successfully");
     }
 
-    // AsyncWebServer handles requests asynchronously
-    // No need for explicit loop processing
+    // AsyncWebServer handles requests asynchronously; device command results
+    // and telemetry replays are handed over here and sent from the network task
+    completeCommands();
+    replayStreams();
 }
 
-void HTTPServer::setupRoutes() {
-    // Enable CORS for all routes
-    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Origin", "*");
-    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Headers", "Content-Type");
-
-    // Device Management Endpoints
-    server->on("/api/v1/device/info", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetDeviceInfo(request); });
-
-    server->on("/api/v1/device/status", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetDeviceStatus(request); });
-
-    server->on("/api/v1/device/start", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Start command received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleDeviceStart(request, data, len, index, total);
-        });
+// ============================================================================
+// API Routing
+// ============================================================================
 
-    server->on("/api/v1/device/stop", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleDeviceStop(request); });
+#define API_PREFIX "/api/v1"
+#define CONTENT_TYPE_JSON "application/json"
+#define CONTENT_TYPE_MSGPACK "application/msgpack"
+#define API_PREFIX_LEN (sizeof(API_PREFIX) - 1)
+
+// Handlers that take a JSON body are ROUTE_BODY; the body is collected and parsed first
+#define ROUTE(method, path, handler) \
+    { method, path, routeKey(method, path), &HTTPServer::handler, nullptr }
+#define ROUTE_BODY(method, path, handler) \
+    { method, path, routeKey(method, path), nullptr, &HTTPServer::handler }
+
+// Paths are relative to API_PREFIX. Adding a route only needs an entry here;
+// the perfect hash is recomputed at compile time.
+struct HTTPServer::Routes {
+    static constexpr Route TABLE[] = {
+        // Device Management
+        ROUTE(HTTP_GET, "/device/info", handleGetDeviceInfo),
+        ROUTE(HTTP_GET, "/device/status", handleGetDeviceStatus),
+        ROUTE_BODY(HTTP_POST, "/device/start", handleDeviceStart),
+        ROUTE(HTTP_POST, "/device/stop", handleDeviceStop),
+        ROUTE(HTTP_POST, "/device/pause", handleDevicePause),
+        ROUTE(HTTP_POST, "/device/resume", handleDeviceResume),
+        ROUTE_BODY(HTTP_PUT, "/device/setpoint", handleSetSetpoint),
+        ROUTE_BODY(HTTP_POST, "/device/test", handleDeviceTest),
+        ROUTE_BODY(HTTP_POST, "/batch", handleBatch),
+
+#ifdef DEVICE_TYPE_PCR
+        // Program Management
+        ROUTE(HTTP_GET, "/device/program/templates", handleProgramTemplates),
+        ROUTE_BODY(HTTP_POST, "/device/program/validate", handleProgramValidate),
+#endif
+
+#ifdef DEVICE_TYPE_INCUBATOR
+        // Protocol Management
+        ROUTE(HTTP_GET, "/device/protocol/templates", handleProtocolTemplates),
+        ROUTE_BODY(HTTP_POST, "/device/protocol/start", handleProtocolStart),
+        ROUTE(HTTP_POST, "/device/protocol/stop", handleProtocolStop),
+        ROUTE(HTTP_POST, "/device/protocol/pause", handleProtocolPause),
+        ROUTE(HTTP_POST, "/device/protocol/resume", handleProtocolResume),
+        ROUTE(HTTP_POST, "/device/protocol/next-stage", handleProtocolNextStage),
+
+        // Alarm Management
+        ROUTE(HTTP_GET, "/device/alarms", handleGetAlarms),
+        ROUTE_BODY(HTTP_POST, "/device/alarms/acknowledge", handleAcknowledgeAlarm),
+        ROUTE(HTTP_POST, "/device/alarms/acknowledge-all", handleAcknowledgeAllAlarms),
+        ROUTE(HTTP_GET, "/device/alarms/history", handleGetAlarmHistory),
+#endif
+
+        // WiFi Configuration (scanning is left to the mobile app/browser)
+        ROUTE(HTTP_GET, "/wifi/status", handleGetWiFiStatus),
+        ROUTE_BODY(HTTP_POST, "/wifi/configure", handleWiFiConfigure),
+
+        // Configuration
+        ROUTE(HTTP_GET, "/config", handleGetConfig),
+        ROUTE_BODY(HTTP_POST, "/config", handleSetConfig),
+        ROUTE(HTTP_POST, "/config/factory-reset", handleFactoryReset),
+
+        // Diagnostics
+        ROUTE(HTTP_GET, "/metrics", handleGetMetrics)
+    };
 
-    server->on("/api/v1/device/pause", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleDevicePause(request); });
+    static constexpr size_t COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+};
 
-    server->on("/api/v1/device/resume", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleDeviceResume(request); });
+constexpr HTTPServer::Route HTTPServer::Routes::TABLE[];
 
-    server->on("/api/v1/device/setpoint", HTTP_PUT,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Setpoint update received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleSetSetpoint(request, data, len, index, total);
-        });
+class HTTPServer::ApiRouter : public AsyncWebHandler {
+public:
+    explicit ApiRouter(HTTPServer& s) : server(s) {}
 
-    // Program Management Endpoints (PCR-specific features)
-    server->on("/api/v1/device/program/validate", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Program validation received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleProgramValidate(request, data, len, index, total);
-        });
+    bool canHandle(AsyncWebServerRequest* request) override {
+        if (!find(request)) {
+            return false;
+        }
+        // Keep every header, as the per-route callback handlers used to
+        request->addInterestingHeader("ANY");
+        return true;
+    }
 
-    server->on("/api/v1/device/program/templates", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleProgramTemplates(request); });
+    void handleRequest(AsyncWebServerRequest* request) override {
+        const Route* route = find(request);
+        if (!route) {
+            return;
+        }
 
-    // Protocol Management Endpoints (Incubator-specific features)
-    server->on("/api/v1/device/protocol/templates", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleProtocolTemplates(request); });
+        // Timed from here; the send helpers stop the clock
+        server.metrics.begin(request, ApiMetrics::offset(server.metricsBase, route - Routes::TABLE));
 
-    server->on("/api/v1/device/protocol/start", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Protocol start received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleProtocolStart(request, data, len, index, total);
-        });
+        uint32_t retryAfter = 0;
+        AdmissionControl::Verdict verdict = server.admission.admit(request->client()->remoteIP(), retryAfter);
+        if (verdict != AdmissionControl::ADMITTED) {
+            server.bodyPool.release(request);
+            server.sendRejected(request, verdict, retryAfter);
+            return;
+        }
 
-    server->on("/api/v1/device/protocol/stop", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleProtocolStop(request); });
+        // Handlers run in the network stack's context; on the ESP8266 that
+        // time comes straight out of the control loop
+        uint32_t startedAt = micros();
+        if (route->bodyHandler) {
+            server.dispatchBody(request, route->bodyHandler);
+        } else {
+            (server.*(route->handler))(request);
+        }
+        server.admission.charge(micros() - startedAt);
+    }
 
-    server->on("/api/v1/device/protocol/pause", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleProtocolPause(request); });
+    void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                    size_t index, size_t total) override {
+        const Route* route = find(request);
+        if (route && route->bodyHandler) {
+            server.collectBody(request, data, len, index, total);
+        }
+    }
 
-    server->on("/api/v1/device/protocol/resume", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleProtocolResume(request); });
+    bool isRequestHandlerTrivial() override {
+        return false;
+    }
 
-    server->on("/api/v1/device/protocol/next-stage", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleProtocolNextStage(request); });
+private:
+    // 128 slots keeps the compile-time seed search short for up to ~30 routes
+    typedef RouteTable<Routes, 7> Table;
 
-    // Alarm Management Endpoints (Incubator-specific features)
-    server->on("/api/v1/device/alarms", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetAlarms(request); });
+    HTTPServer& server;
 
-    server->on("/api/v1/device/alarms/acknowledge", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Alarm acknowledge received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleAcknowledgeAlarm(request, data, len, index, total);
-        });
+    static const Route* find(AsyncWebServerRequest* request) {
+        const String& url = request->url();
+        if (!url.startsWith(API_PREFIX "/")) {
+            return nullptr;
+        }
 
-    server->on("/api/v1/device/alarms/acknowledge-all", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleAcknowledgeAllAlarms(request); });
+        const char* path = url.c_str() + API_PREFIX_LEN;
+        size_t len = url.length() - API_PREFIX_LEN;
+        uint32_t key = Hash::fnv1aN(path, len, Hash::FNV_OFFSET ^ request->method());
 
-    server->on("/api/v1/device/alarms/history", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetAlarmHistory(request); });
+        int index = Table::find(key);
+        if (index < 0 || strcmp(Routes::TABLE[index].path, path) != 0) {
+            return nullptr;
+        }
+        return &Routes::TABLE[index];
+    }
+};
 
-    // WiFi Configuration Endpoints
-    server->on("/api/v1/wifi/status", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetWiFiStatus(request); });
+/**
+ * GET /device/stream. Outside the route table: a stream never finishes, so
+ * it has no place in the request metrics, and admission is bounded by
+ * HTTP_STREAM_MAX_CLIENTS instead.
+ */
+class HTTPServer::StreamHandler : public AsyncWebHandler {
+public:
+    explicit StreamHandler(HTTPServer& s) : server(s) {}
 
-    // WiFi scan disabled - mobile app/browser handles network scanning
-    // server->on("/api/v1/wifi/scan", HTTP_GET,
-    //     [this](AsyncWebServerRequest* request) { handleWiFiScan(request); });
+    bool canHandle(AsyncWebServerRequest* request) override {
+        if (request->method() != HTTP_GET || request->url() != API_PREFIX "/device/stream") {
+            return false;
+        }
+        request->addInterestingHeader("Last-Event-ID");
+        return true;
+    }
 
-    server->on("/api/v1/wifi/configure", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "WiFi configuration received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleWiFiConfigure(request, data, len, index, total);
-        });
+    void handleRequest(AsyncWebServerRequest* request) override;
 
-    // Configuration Endpoints
-    server->on("/api/v1/config", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleGetConfig(request); });
+    bool isRequestHandlerTrivial() override {
+        return false;
+    }
 
-    server->on("/api/v1/config/factory-reset", HTTP_POST,
-        [this](AsyncWebServerRequest* request) { handleFactoryReset(request); });
+private:
+    HTTPServer& server;
+};
 
-    server->on("/api/v1/config", HTTP_POST,
-        [](AsyncWebServerRequest* request) {
-            // Nothing needed in header handler
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleSetConfig(request, data, len, index, total);
-        });
+void HTTPServer::setupRoutes() {
+    // Enable CORS for all routes
+    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Origin", "*");
+    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+    DefaultHeaders::Instance().addHeader("Access-Control-Allow-Headers", "Content-Type, If-None-Match");
+    DefaultHeaders::Instance().addHeader("Access-Control-Expose-Headers", "ETag, Retry-After");
 
-    // Diagnostic / Test Endpoints
-    server->on("/api/v1/device/test", HTTP_POST,
-        [this](AsyncWebServerRequest* request) {
-            sendSuccess(request, "Test command received");
-        },
-        NULL,
-        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-            handleDeviceTest(request, data, len, index, total);
-        });
+    // Every REST endpoint goes through one handler, see API Routing above
+    server->addHandler(new ApiRouter(*this));
 
-    // Provisioning page (captive portal)
-    server->on("/", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleProvisioningPage(request); });
+    // Telemetry pushed over the HTTP port, for networks that block the WebSocket port
+    server->addHandler(new StreamHandler(*this));
 
-    server->on("/provision", HTTP_GET,
-        [this](AsyncWebServerRequest* request) { handleProvisioningPage(request); });
+    // Provisioning page (captive portal), gzipped at build time and served from flash.
+    // Phones re-request it constantly during onboarding, so let them cache it briefly.
+    FlashAsset provisionPage = { "text/html", PROVISION_PAGE_GZ, PROVISION_PAGE_GZ_LEN,
+                                 PROVISION_PAGE_ETAG, "gzip", "max-age=300" };
+    server->addHandler(new FlashAssetHandler("/", provisionPage));
+    server->addHandler(new FlashAssetHandler("/provision", provisionPage));
 
     // 404 handler
     server->onNotFound([](AsyncWebServerRequest* request) {
@@ -196,6 +270,30 @@ void HTTPServer::setupRoutes() {
     Logger::info("HTTPServer: Routes configured");
 }
 
+namespace {
+    const char* methodName(uint8_t method) {
+        switch (method) {
+            case HTTP_GET:     return "GET";
+            case HTTP_POST:    return "POST";
+            case HTTP_PUT:     return "PUT";
+            case HTTP_DELETE:  return "DELETE";
+            case HTTP_PATCH:   return "PATCH";
+            default:           return "OTHER";
+        }
+    }
+}
+
+void HTTPServer::registerMetrics() {
+    // One endpoint per route, in table order, so ApiRouter can index them
+    for (size_t i = 0; i < Routes::COUNT; i++) {
+        const Route& route = Routes::TABLE[i];
+        ApiMetrics::Endpoint endpoint = metrics.add("http", methodName(route.method), route.path);
+        if (i == 0) {
+            metricsBase = endpoint;
+        }
+    }
+}
+
 // ============================================================================
 // Helper Methods
 // ============================================================================
@@ -203,16 +301,66 @@ void HTTPServer::setupRoutes() {
 void HTTPServer::enableCORS(AsyncWebServerResponse* response) {
     response->addHeader("Access-Control-Allow-Origin", "*");
     response->addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-    response->addHeader("Access-Control-Allow-Headers", "Content-Type");
+    response->addHeader("Access-Control-Allow-Headers", "Content-Type, If-None-Match");
 }
 
 void HTTPServer::sendJSON(AsyncWebServerRequest* request, int code, const JsonDocument& doc) {
-    String json;
-    serializeJson(doc, json);
+    request->send(beginJSON(request, code, doc));
+}
+
+AsyncWebServerResponse* HTTPServer::beginJSON(AsyncWebServerRequest* request, int code, const JsonDocument& doc) {
+    size_t length = 0;
+    AsyncResponseStream* response = beginDocument(request, doc, length);
+    response->setCode(code);
+    response->addHeader("Vary", "Accept");
 
-    AsyncWebServerResponse* response = request->beginResponse(code, "application/json", json);
     enableCORS(response);
-    request->send(response);
+    metrics.end(request, code, length);
+    return response;
+}
+
+bool HTTPServer::acceptsMsgPack(AsyncWebServerRequest* request) {
+    // Also matches application/x-msgpack
+    return request->hasHeader("Accept") &&
+           request->getHeader("Accept")->value().indexOf("msgpack") >= 0;
+}
+
+void HTTPServer::sendCatalog(AsyncWebServerRequest* request, const FlashAsset& catalog) {
+    if (acceptsMsgPack(request)) {
+        // Catalogs are fetched rarely, so the flash copy is converted on demand
+        JsonDocument doc;
+        deserializeJson(doc, (const __FlashStringHelper*)catalog.data, catalog.length);
+        sendJSON(request, 200, doc);
+        return;
+    }
+
+    int code = FlashAssetHandler::send(request, catalog);
+    metrics.end(request, code, code == 200 ? catalog.length : 0);
+}
+
+AsyncResponseStream* HTTPServer::beginDocument(AsyncWebServerRequest* request, const JsonDocument& doc,
+                                               size_t& length) {
+    // Serialize straight into the response buffer, sized up front. The stream is
+    // a ring buffer that keeps one byte free, so it needs length + 1 to hold the
+    // body without reallocating on the last write.
+    AsyncResponseStream* response;
+    if (acceptsMsgPack(request)) {
+        length = measureMsgPack(doc);
+        response = request->beginResponseStream(CONTENT_TYPE_MSGPACK, length + 1);
+        serializeMsgPack(doc, *response);
+    } else {
+        length = measureJson(doc);
+        response = request->beginResponseStream(CONTENT_TYPE_JSON, length + 1);
+        serializeJson(doc, *response);
+    }
+
+    // Document and serialized body are both alive here, the peak for this request
+    uint32_t freeHeap = DeviceIdentity::getFreeHeap();
+    if (freeHeap < heapLowWater) {
+        heapLowWater = freeHeap;
+    }
+
+    return response;
 }
 
 void HTTPServer::sendError(AsyncWebServerRequest* request, int code, const String& error) {
@@ -229,6 +377,515 @@ void HTTPServer::sendSuccess(AsyncWebServerRequest* request, const String& messa
     sendJSON(request, 200, doc);
 }
 
+void HTTPServer::sendRejected(AsyncWebServerRequest* request, AdmissionControl::Verdict verdict,
+                              uint32_t retryAfter) {
+    // Fixed bodies: a flood should cost as little as possible to turn away
+    AsyncWebServerResponse* response;
+    int code;
+    if (verdict == AdmissionControl::CLIENT_LIMITED) {
+        code = 429;
+        response = request->beginResponse(code, "application/json",
+                                          "{\"success\":false,\"error\":\"Too many requests\"}");
+    } else {
+        code = 503;
+        response = request->beginResponse(code, "application/json",
+                                          "{\"success\":false,\"error\":\"Device busy, try again\"}");
+    }
+
+    response->addHeader("Retry-After", String(retryAfter));
+    enableCORS(response);
+    metrics.end(request, code, 0);
+    request->send(response);
+}
+
+// ============================================================================
+// Request Body Handling
+// ============================================================================
+
+void HTTPServer::collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        // Free the slot if the client goes away before the body is complete
+        request->onDisconnect([this, request]() { bodyPool.release(request); });
+    }
+
+    // Errors are reported once the request completes, see dispatchBody()
+    bodyPool.append(request, data, len, index, total);
+}
+
+void HTTPServer::dispatchBody(AsyncWebServerRequest* request, BodyHandler handler) {
+    size_t contentLength = request->contentLength();
+
+    if (contentLength > bodyPool.capacity()) {
+        bodyPool.release(request);
+        sendError(request, 413, "Request body too large (max " + String(bodyPool.capacity()) + " bytes)");
+        return;
+    }
+
+    JsonDocument body;
+
+    if (contentLength > 0) {
+        size_t len = 0;
+        const char* data = bodyPool.get(request, len);
+
+        if (!data || len != contentLength) {
+            bodyPool.release(request);
+            sendError(request, 503, "Request body could not be buffered, try again");
+            return;
+        }
+
+        // Parsed exactly once, from the complete body
+        DeserializationError error = deserializeJson(body, data, len);
+        bodyPool.release(request);
+
+        if (error) {
+            sendError(request, 400, "Invalid JSON: " + String(error.c_str()));
+            return;
+        }
+    }
+
+    (this->*handler)(request, body);
+}
+
+bool HTTPServer::runAfterResponse(AsyncWebServerRequest* request, DeferredActions::Action action) {
+    DeferredActions::Handle handle = deferred.schedule(AFTER_RESPONSE_TIMEOUT_MS, action);
+    if (handle == DeferredActions::NO_ACTION) {
+        return false;
+    }
+
+    // The client closes the connection once it has read the whole response
+    request->onDisconnect([this, handle]() { deferred.expedite(handle, AFTER_RESPONSE_GRACE_MS); });
+    return true;
+}
+
+// ============================================================================
+// Device Commands
+// ============================================================================
+
+namespace {
+    // Response for each DeviceCommand::Type, indexed by type
+    struct CommandReply {
+        const char* success;
+        int failCode;
+        const char* failure;
+    };
+
+    const CommandReply COMMAND_REPLIES[] = {
+        { "Device started successfully",   500, "Failed to start device" },
+        { "Device stopped successfully",   500, "Failed to stop device" },
+        { "Device paused successfully",    400, "Cannot pause device in current state" },
+        { "Device resumed successfully",   400, "Cannot resume device in current state" },
+        { "Setpoint updated successfully", 400, "Invalid zone or temperature value" },
+        { "Test command executed",         400, "Test command not supported or device is busy" },
+        { "Batch executed",                400, "Batch operation failed" },
+        { "Alarm acknowledged",            404, "No active alarm at that index" },
+        { "All alarms acknowledged",       500, "Failed to acknowledge alarms" }
+    };
+}
+
+#ifdef ESP32
+/**
+ * Handed to the request as soon as a command is queued, and empty until
+ * loop() has posted the result. The request's poll and ack callbacks run on
+ * the network task; the first one after the result is in builds the real
+ * response and passes everything on to it, so loop() never touches the
+ * request and nothing ever waits for the other side.
+ */
+class HTTPServer::CommandResponse : public AsyncWebServerResponse {
+public:
+    CommandResponse(HTTPServer& s, uint32_t commandId) : server(s), id(commandId), inner(nullptr) {}
+
+    ~CommandResponse() override {
+        delete inner;
+    }
+
+    bool _sourceValid() const override { return true; }
+    bool _started() const override { return inner && inner->_started(); }
+    bool _finished() const override { return inner && inner->_finished(); }
+    bool _failed() const override { return inner && inner->_failed(); }
+
+    void _respond(AsyncWebServerRequest* request) override {
+        start(request);
+    }
+
+    size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override {
+        if (inner) {
+            return inner->_ack(request, len, time);
+        }
+        start(request);
+        return 0;
+    }
+
+private:
+    HTTPServer& server;
+    uint32_t id;
+    AsyncWebServerResponse* inner;      // Real response, once the result is in
+
+    void start(AsyncWebServerRequest* request) {
+        inner = server.takeCommandResponse(request, id);
+        if (inner) {
+            inner->_respond(request);
+        }
+    }
+};
+#endif
+
+void HTTPServer::submitCommand(AsyncWebServerRequest* request, DeviceCommand& command) {
+    PendingCommand* slot = nullptr;
+    uint32_t id = 0;
+    {
+        CriticalSection lock(pendingMux);
+        for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+            if (pendingCommands[i].id == 0) {
+                slot = &pendingCommands[i];
+                // Ids only need to be unique among pending commands; skip 0
+                if (++nextCommandId == 0) nextCommandId = 1;
+                slot->id = id = nextCommandId;
+                slot->request = request;
+                slot->type = command.type;
+                slot->submittedAt = millis();
+                slot->ready = false;
+                slot->timedOut = false;
+                break;
+            }
+        }
+    }
+
+    if (slot) {
+        // Replaces the body pool handler from collectBody(); the body is already released
+        request->onDisconnect([this, request]() { abandonCommand(request); });
+
+        command.id = id;
+        if (device.getCommandQueue().submit(CommandQueue::LANE_HTTP, command)) {
+#ifdef ESP32
+            // loop() runs on another task, so the response waits on the network side
+            request->send(new CommandResponse(*this, id));
+#endif
+            return;
+        }
+
+        CriticalSection lock(pendingMux);
+        slot->id = 0;
+        slot->request = nullptr;
+    }
+
+    sendError(request, 503, "Device busy, try again");
+}
+
+void HTTPServer::abandonCommand(AsyncWebServerRequest* request) {
+    // Runs on the network task just before the request is deleted. A result
+    // already posted goes with the slot; a late one finds no slot and is dropped.
+    JsonDocument dropped;
+    {
+        CriticalSection lock(pendingMux);
+        PendingCommand* slot = findPending(request);
+        if (!slot) {
+            return;
+        }
+        dropped = std::move(slot->data);
+        slot->id = 0;
+        slot->request = nullptr;
+    }
+    metrics.abandon(request);
+}
+
+void HTTPServer::completeCommands() {
+    CommandResult result;
+    while (device.getCommandQueue().takeResult(CommandQueue::LANE_HTTP, result)) {
+        postResult(result.id, &result);
+    }
+
+    // Commands the control loop has not answered in time
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        CriticalSection lock(pendingMux);
+        PendingCommand& slot = pendingCommands[i];
+        if (slot.id != 0 && !slot.ready && now - slot.submittedAt > HTTP_COMMAND_TIMEOUT_MS) {
+            slot.ready = true;
+            slot.timedOut = true;
+        }
+    }
+
+#ifndef ESP32
+    sendReadyCommands();
+#endif
+}
+
+#ifndef ESP32
+void HTTPServer::sendReadyCommands() {
+    // ESP8266 only: loop() and the network callbacks share one thread, so a
+    // request that still has a slot is alive (abandonCommand frees the slot
+    // on disconnect) and can be answered right here, without waiting for a poll
+    for (PendingCommand& slot : pendingCommands) {
+        if (slot.id == 0 || !slot.ready) continue;
+        AsyncWebServerRequest* request = slot.request;
+        request->send(takeCommandResponse(request, slot.id));
+    }
+}
+#endif
+
+void HTTPServer::postResult(uint32_t id, CommandResult* result) {
+    // The slot's document is empty until posted, so the move frees nothing under the lock
+    CriticalSection lock(pendingMux);
+    PendingCommand* slot = findPending(id);
+    if (!slot || slot->ready) {
+        return;
+    }
+    slot->success = result->success;
+    slot->data = std::move(result->data);
+    slot->ready = true;
+}
+
+AsyncWebServerResponse* HTTPServer::takeCommandResponse(AsyncWebServerRequest* request, uint32_t id) {
+    DeviceCommand::Type type;
+    bool success;
+    bool timedOut;
+    JsonDocument doc;
+    {
+        CriticalSection lock(pendingMux);
+        PendingCommand* slot = findPending(id);
+        if (!slot || !slot->ready) {
+            return nullptr;
+        }
+        type = slot->type;
+        success = slot->success;
+        timedOut = slot->timedOut;
+        doc = std::move(slot->data);
+        slot->id = 0;
+        slot->request = nullptr;
+    }
+
+    int code;
+    if (timedOut) {
+        // The command may still be applied once the control loop catches up
+        doc.clear();
+        doc["success"] = false;
+        doc["error"] = "Device did not respond in time";
+        code = 504;
+    } else {
+        code = describeResult(type, success, doc);
+    }
+    return beginJSON(request, code, doc);
+}
+
+HTTPServer::PendingCommand* HTTPServer::findPending(uint32_t id) {
+    for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        if (id != 0 && pendingCommands[i].id == id) {
+            return &pendingCommands[i];
+        }
+    }
+    return nullptr;
+}
+
+HTTPServer::PendingCommand* HTTPServer::findPending(AsyncWebServerRequest* request) {
+    for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        if (pendingCommands[i].id != 0 && pendingCommands[i].request == request) {
+            return &pendingCommands[i];
+        }
+    }
+    return nullptr;
+}
+
+int HTTPServer::describeResult(DeviceCommand::Type type, bool success, JsonDocument& doc) {
+    // Per-operation results; the status code reflects the batch as a whole
+    if (type == DeviceCommand::BATCH) {
+        return success ? 200 : 400;
+    }
+
+    const CommandReply& reply = COMMAND_REPLIES[type];
+    doc.clear();
+    doc["success"] = success;
+    if (success) {
+        doc["message"] = reply.success;
+        return 200;
+    }
+    doc["error"] = reply.failure;
+    return reply.failCode;
+}
+
+// ============================================================================
+// Telemetry Stream
+// ============================================================================
+
+/**
+ * One open telemetry stream. Like CommandResponse it only runs from the
+ * request's poll and ack callbacks on the network task, where it writes
+ * whatever loop() has left in its StreamClient slot: replay pages first,
+ * then the latest telemetry message whenever a newer sample is in.
+ */
+class HTTPServer::StreamResponse : public AsyncWebServerResponse {
+public:
+    StreamResponse(HTTPServer& s, uint8_t streamSlot, uint32_t lastId)
+        : server(s), slot(streamSlot), sentId(lastId) {}
+
+    ~StreamResponse() override {
+        // The request is deleted on disconnect, and this with it
+        std::shared_ptr<const String> dropped;
+        CriticalSection lock(server.telemetryMux);
+        StreamClient& stream = server.streamClients[slot];
+        stream.active = false;
+        stream.resuming = false;
+        stream.replay.swap(dropped);
+        server.streamCount--;
+    }
+
+    bool _sourceValid() const override { return true; }
+    bool _started() const override { return true; }
+    bool _finished() const override { return false; }
+    bool _failed() const override { return false; }
+
+    void _respond(AsyncWebServerRequest* request) override {
+        static const char HEAD[] =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/event-stream\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Connection: keep-alive\r\n"
+            "Access-Control-Allow-Origin: *\r\n\r\n";
+        request->client()->setRxTimeout(0);
+        request->client()->write(HEAD, sizeof(HEAD) - 1);
+        pump(request->client());
+    }
+
+    size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override {
+        pump(request->client());
+        return 0;
+    }
+
+private:
+    // "id: <seq>\nevent: telemetry\ndata: " and the closing blank line
+    static const size_t FRAME_OVERHEAD = 52;
+
+    HTTPServer& server;
+    uint8_t slot;
+    uint32_t sentId;            // Seq of the last sample written
+
+    void pump(AsyncClient* client) {
+        size_t room = client->space();
+        std::shared_ptr<const String> message;
+        uint32_t id = 0;
+        bool replay = false;
+        {
+            CriticalSection lock(server.telemetryMux);
+            StreamClient& stream = server.streamClients[slot];
+            if (stream.replay) {
+                if (stream.replay->length() + FRAME_OVERHEAD > room) return;
+                message.swap(stream.replay);
+                id = stream.replayNext;
+                replay = true;
+                // Another page until the replay has caught up with the live stream
+                if (id < server.latestTelemetryId) {
+                    stream.resumeSince = id;
+                    stream.resuming = true;
+                }
+            } else if (!stream.resuming && server.latestTelemetry && server.latestTelemetryId > sentId) {
+                if (server.latestTelemetry->length() + FRAME_OVERHEAD > room) return;
+                message = server.latestTelemetry;
+                id = server.latestTelemetryId;
+            }
+        }
+        if (!message) {
+            return;
+        }
+
+        char head[48];
+        int headLength = snprintf(head, sizeof(head), "id: %lu\nevent: %s\ndata: ",
+                                  (unsigned long)id, replay ? "replay" : "telemetry");
+        client->add(head, headLength);
+        client->add(message->c_str(), message->length());
+        client->add("\n\n", 2);
+        client->send();
+        sentId = id;
+    }
+};
+
+void HTTPServer::StreamHandler::handleRequest(AsyncWebServerRequest* request) {
+    AsyncWebHeader* header = request->getHeader("Last-Event-ID");
+    uint32_t lastId = header ? strtoul(header->value().c_str(), nullptr, 10) : 0;
+
+    int slot = -1;
+    {
+        CriticalSection lock(server.telemetryMux);
+        for (uint8_t i = 0; i < HTTP_STREAM_MAX_CLIENTS; i++) {
+            StreamClient& stream = server.streamClients[i];
+            if (stream.active) continue;
+
+            // A reconnect that missed samples gets them replayed from
+            // TelemetryHistory first; an id from before a reboot (ahead of
+            // the live one) replays whatever is kept
+            stream.active = true;
+            stream.session = ++server.nextStreamSession;
+            stream.resuming = server.replaySource && lastId != 0 && lastId != server.latestTelemetryId;
+            stream.resumeSince = lastId;
+            if (lastId > server.latestTelemetryId) {
+                lastId = 0;
+            }
+            server.streamCount++;
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0) {
+        request->send(503, CONTENT_TYPE_JSON, "{\"success\":false,\"error\":\"Too many stream clients\"}");
+        return;
+    }
+    request->send(new StreamResponse(server, slot, lastId));
+    Logger::debug("HTTPServer: Telemetry stream client connected");
+}
+
+void HTTPServer::streamTelemetry(const std::shared_ptr<const String>& message, uint32_t id) {
+    std::shared_ptr<const String> previous = message;
+    {
+        CriticalSection lock(telemetryMux);
+        latestTelemetry.swap(previous);
+        latestTelemetryId = id;
+    }
+    // previous is released here, outside the critical section
+}
+
+bool HTTPServer::wantsTelemetry() {
+    std::shared_ptr<const String> previous;
+    {
+        CriticalSection lock(telemetryMux);
+        if (streamCount > 0) {
+            return true;
+        }
+        latestTelemetry.swap(previous);
+    }
+    return false;
+}
+
+void HTTPServer::replayStreams() {
+    if (!replaySource) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < HTTP_STREAM_MAX_CLIENTS; i++) {
+        uint32_t session;
+        uint32_t since;
+        {
+            CriticalSection lock(telemetryMux);
+            const StreamClient& stream = streamClients[i];
+            if (!stream.active || !stream.resuming) continue;
+            session = stream.session;
+            since = stream.resumeSince;
+        }
+
+        // Built outside the lock, one page per client per pass
+        String page;
+        uint32_t next = replaySource(since, page);
+        std::shared_ptr<const String> message = std::make_shared<const String>(std::move(page));
+        {
+            CriticalSection lock(telemetryMux);
+            StreamClient& stream = streamClients[i];
+            if (stream.active && stream.session == session && stream.resuming) {
+                stream.replay.swap(message);
+                stream.replayNext = next;
+                stream.resuming = false;
+            }
+        }
+    }
+}
+
 // ============================================================================
 // Device Management Handlers
 // ============================================================================
@@ -244,6 +901,25 @@ void HTTPServer::handleGetDeviceInfo(AsyncWebServerRequest* request) {
     doc["firmwareVersion"] = config.device.firmwareVersion;
     doc["uptime"] = device.getUptime();
     doc["freeHeap"] = DeviceIdentity::getFreeHeap();
+    doc["maxFreeBlock"] = DeviceIdentity::getMaxFreeBlock();
+    doc["minFreeHeap"] = heapLowWater;
+
+    // Requests turned away by admission control (HTTP and WebSocket)
+    JsonObject rejected = doc["rejectedRequests"].to<JsonObject>();
+    rejected["rateLimited"] = admission.getRejectedByClient();
+    rejected["busy"] = admission.getRejectedBusy();
+
+    // Size and encode time of the latest status frame per encoding
+    StatusSnapshot::FramePtr frame = device.getStatusSnapshot().get();
+    if (frame) {
+        JsonObject encoding = doc["statusEncoding"].to<JsonObject>();
+        encoding["jsonBytes"] = frame->json.length();
+        encoding["jsonMicros"] = frame->jsonMicros;
+        if (!frame->msgpack.empty()) {
+            encoding["msgpackBytes"] = frame->msgpack.size();
+            encoding["msgpackMicros"] = frame->msgpackMicros;
+        }
+    }
     doc["chipId"] = DeviceIdentity::getChipID();
     doc["mac"] = DeviceIdentity::getMAC();
     doc["httpPort"] = config.network.httpPort;
@@ -255,121 +931,219 @@ void HTTPServer::handleGetDeviceInfo(AsyncWebServerRequest* request) {
 void HTTPServer::handleGetDeviceStatus(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: GET /api/v1/device/status");
 
-    JsonDocument status = device.getStatus();
-    sendJSON(request, 200, status);
-}
+    StatusSnapshot::FramePtr frame = device.getStatusSnapshot().get();
+    if (!frame) {
+        sendError(request, 503, "Status not available yet");
+        return;
+    }
 
-void HTTPServer::handleDeviceStart(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    // Only process when we have all data
-    if (index + len != total) return;
+    // The snapshot version doubles as the ETag; pollers send it back in If-None-Match.
+    // The encodings are different representations, so they get different tags
+    bool msgpack = acceptsMsgPack(request);
+    String etag = "\"" + String(frame->version) + (msgpack ? "-m\"" : "\"");
+
+    AsyncWebServerResponse* response;
+    if (FlashAssetHandler::etagMatches(request, etag.c_str())) {
+        response = request->beginResponse(304);
+        metrics.end(request, 304, 0);
+    } else if (msgpack) {
+        // Ask the control loop to encode MessagePack alongside JSON from now on
+        device.getStatusSnapshot().wantMsgPack();
+
+        if (!request->hasParam("fields") && !frame->msgpack.empty()) {
+            response = request->beginResponse(CONTENT_TYPE_MSGPACK, frame->msgpack.size(),
+                [frame](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                    size_t remaining = frame->msgpack.size() - index;
+                    size_t n = remaining < maxLen ? remaining : maxLen;
+                    memcpy(buffer, frame->msgpack.data() + index, n);
+                    return n;
+                });
+            metrics.end(request, 200, frame->msgpack.size());
+        } else {
+            // Projection, or the first request before the loop has encoded one: convert here
+            String json;
+            if (request->hasParam("fields")) {
+                frame->project(FieldList(request->getParam("fields")->value().c_str()), json);
+            } else {
+                json = frame->json;
+            }
+            JsonDocument doc;
+            deserializeJson(doc, json);
+            size_t length = 0;
+            response = beginDocument(request, doc, length);
+            metrics.end(request, 200, length);
+        }
+    } else if (request->hasParam("fields")) {
+        // ?fields=a,b: splice just those members out of the serialized frame
+        String json;
+        frame->project(FieldList(request->getParam("fields")->value().c_str()), json);
+        metrics.end(request, 200, json.length());
+        response = request->beginResponse(200, CONTENT_TYPE_JSON, json);
+    } else {
+        // Stream straight out of the shared frame; the lambda keeps it alive until sent
+        response = request->beginResponse(CONTENT_TYPE_JSON, frame->json.length(),
+            [frame](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                size_t remaining = frame->json.length() - index;
+                size_t n = remaining < maxLen ? remaining : maxLen;
+                memcpy(buffer, frame->json.c_str() + index, n);
+                return n;
+            });
+        metrics.end(request, 200, frame->json.length());
+    }
 
-    Logger::info("HTTPServer: POST /api/v1/device/start");
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    response->addHeader("Vary", "Accept");
+    enableCORS(response);
+    request->send(response);
+}
 
-    // Parse JSON body
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
+void HTTPServer::handleDeviceStart(AsyncWebServerRequest* request, JsonDocument& doc) {
+    Logger::info("HTTPServer: POST /api/v1/device/start");
 
-    if (error) {
-        sendError(request, 400, "Invalid JSON");
+    const char* invalid = device.checkParams(DeviceCommand::START, 0, 0, 0.0f, doc.as<JsonVariantConst>());
+    if (invalid) {
+        sendError(request, 400, invalid);
         return;
     }
 
     // Start device with parameters
-    bool success = device.start(doc);
-
-    if (success) {
-        sendSuccess(request, "Device started successfully");
-    } else {
-        sendError(request, 500, "Failed to start device");
-    }
+    DeviceCommand command;
+    command.type = DeviceCommand::START;
+    command.params = doc;
+    submitCommand(request, command);
 }
 
 void HTTPServer::handleDeviceStop(AsyncWebServerRequest* request) {
     Logger::info("HTTPServer: POST /api/v1/device/stop");
 
-    bool success = device.stop();
-
-    if (success) {
-        sendSuccess(request, "Device stopped successfully");
-    } else {
-        sendError(request, 500, "Failed to stop device");
-    }
+    DeviceCommand command;
+    command.type = DeviceCommand::STOP;
+    submitCommand(request, command);
 }
 
 void HTTPServer::handleDevicePause(AsyncWebServerRequest* request) {
     Logger::info("HTTPServer: POST /api/v1/device/pause");
 
-    bool success = device.pause();
-
-    if (success) {
-        sendSuccess(request, "Device paused successfully");
-    } else {
-        sendError(request, 400, "Cannot pause device in current state");
-    }
+    DeviceCommand command;
+    command.type = DeviceCommand::PAUSE;
+    submitCommand(request, command);
 }
 
 void HTTPServer::handleDeviceResume(AsyncWebServerRequest* request) {
     Logger::info("HTTPServer: POST /api/v1/device/resume");
 
-    bool success = device.resume();
-
-    if (success) {
-        sendSuccess(request, "Device resumed successfully");
-    } else {
-        sendError(request, 400, "Cannot resume device in current state");
-    }
+    DeviceCommand command;
+    command.type = DeviceCommand::RESUME;
+    submitCommand(request, command);
 }
 
-void HTTPServer::handleDeviceTest(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    if (index + len != total) return;
-
+void HTTPServer::handleDeviceTest(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::info("HTTPServer: POST /api/v1/device/test");
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
+    const char* invalid = device.checkParams(DeviceCommand::TEST, 0, 0, 0.0f, doc.as<JsonVariantConst>());
+    if (invalid) {
+        sendError(request, 400, invalid);
+        return;
+    }
 
-    if (error) {
-        sendError(request, 400, "Invalid JSON");
+    DeviceCommand command;
+    command.type = DeviceCommand::TEST;
+    command.params = doc;
+    submitCommand(request, command);
+}
+
+void HTTPServer::handleBatch(AsyncWebServerRequest* request, JsonDocument& doc) {
+    Logger::info("HTTPServer: POST /api/v1/batch");
+
+    JsonArray operations = doc["operations"];
+    if (operations.isNull() || operations.size() == 0) {
+        sendError(request, 400, "Missing required field: operations");
+        return;
+    }
+    if (operations.size() > BATCH_MAX_OPERATIONS) {
+        sendError(request, 400, "Too many operations (max " + String(BATCH_MAX_OPERATIONS) + ")");
         return;
     }
 
-    bool success = device.runTest(doc);
+    // Reject the whole batch up front, so a bad entry never leaves it half applied
+    uint8_t index = 0;
+    for (JsonVariant operation : operations) {
+        const char* name = operation["op"];
+        DeviceCommand::Type type;
+        String prefix = "Operation " + String(index++) + ": ";
 
-    if (success) {
-        sendSuccess(request, "Test command executed");
-    } else {
-        sendError(request, 400, "Test command not supported or device is busy");
+        if (!name) {
+            sendError(request, 400, prefix + "missing 'op'");
+            return;
+        }
+        if (strcmp(name, "get_status") == 0) {
+            continue;
+        }
+        if (!DeviceCommand::typeFromName(name, type)) {
+            sendError(request, 400, prefix + "unknown op '" + String(name) + "'");
+            return;
+        }
+        if (type == DeviceCommand::SETPOINT &&
+            (operation["zone"].isNull() || operation["temperature"].isNull())) {
+            sendError(request, 400, prefix + "missing required fields: zone, temperature");
+            return;
+        }
+        const char* invalid = device.checkParams(type, 0, operation["zone"] | 0, operation["temperature"] | 0.0f,
+                                                 operation["params"].as<JsonVariantConst>());
+        if (invalid) {
+            sendError(request, 400, prefix + invalid);
+            return;
+        }
     }
-}
 
-void HTTPServer::handleSetSetpoint(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    if (index + len != total) return;
+    DeviceCommand command;
+    command.type = DeviceCommand::BATCH;
+    command.params = operations;
+    submitCommand(request, command);
+}
 
+void HTTPServer::handleSetSetpoint(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::info("HTTPServer: PUT /api/v1/device/setpoint");
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
-
-    if (error) {
-        sendError(request, 400, "Invalid JSON");
+    if (doc["zone"].isNull() || doc["temperature"].isNull()) {
+        sendError(request, 400, "Missing required fields: zone, temperature");
         return;
     }
 
-    if (doc["zone"].isNull() || doc["temperature"].isNull()) {
-        sendError(request, 400, "Missing required fields: zone, temperature");
+    DeviceCommand command;
+    command.type = DeviceCommand::SETPOINT;
+    command.zone = doc["zone"];
+    command.value = doc["temperature"];
+
+    const char* invalid = device.checkParams(command.type, 0, command.zone, command.value, JsonVariantConst());
+    if (invalid) {
+        sendError(request, 400, invalid);
         return;
     }
+    submitCommand(request, command);
+}
 
-    uint8_t zone = doc["zone"];
-    float temperature = doc["temperature"];
+// ============================================================================
+// Metrics
+// ============================================================================
 
-    bool success = device.setSetpoint(zone, temperature);
+void HTTPServer::handleGetMetrics(AsyncWebServerRequest* request) {
+    Logger::debug("HTTPServer: GET /api/v1/metrics");
 
-    if (success) {
-        sendSuccess(request, "Setpoint updated successfully");
-    } else {
-        sendError(request, 400, "Invalid zone or temperature value");
-    }
+    // Recorded first, so a scrape counts itself (without its own size)
+    metrics.end(request, 200, 0);
+
+    // Rendered line by line while the response goes out, never held whole
+    ApiMetrics::Exporter exporter(metrics);
+    AsyncWebServerResponse* response = request->beginChunkedResponse("text/plain; version=0.0.4",
+        [exporter](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+            return exporter.read(buffer, maxLen);
+        });
+
+    response->addHeader("Cache-Control", "no-store");
+    enableCORS(response);
+    request->send(response);
 }
 
 // ============================================================================
@@ -408,19 +1182,9 @@ void HTTPServer::handleGetWiFiStatus(AsyncWebServerRequest* request) {
 }
 
 
-void HTTPServer::handleWiFiConfigure(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    if (index + len != total) return;
-
+void HTTPServer::handleWiFiConfigure(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::info("HTTPServer: POST /api/v1/wifi/configure");
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
-
-    if (error) {
-        sendError(request, 400, "Invalid JSON");
-        return;
-    }
-
     if (doc["ssid"].isNull() || doc["password"].isNull()) {
         sendError(request, 400, "Missing required fields: ssid, password");
         return;
@@ -430,8 +1194,14 @@ void HTTPServer::handleWiFiConfigure(AsyncWebServerRequest* request, uint8_t* da
     String password = doc["password"];
     DeviceConfig::WiFiMode mode = static_cast<DeviceConfig::WiFiMode>(doc["mode"] | DeviceConfig::STA_ONLY);
 
-    // Set WiFi credentials
-    wifi.setCredentials(ssid, password, mode);
+    // Switching networks can drop this connection, so reply first
+    bool scheduled = runAfterResponse(request, [this, ssid, password, mode]() {
+        wifi.setCredentials(ssid, password, mode);
+    });
+    if (!scheduled) {
+        sendError(request, 503, "Device busy, try again");
+        return;
+    }
 
     JsonDocument response;
     response["success"] = true;
@@ -446,21 +1216,23 @@ void HTTPServer::handleWiFiConfigure(AsyncWebServerRequest* request, uint8_t* da
 void HTTPServer::handleGetConfig(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: GET /api/v1/config");
 
-    String configJSON = config.toJSON();
+    // ?fields=wifi,network builds only those sections
+    String fields = request->hasParam("fields") ? request->getParam("fields")->value() : String();
 
-    AsyncWebServerResponse* response = request->beginResponse(200, "application/json", configJSON);
-    enableCORS(response);
-    request->send(response);
+    JsonDocument doc;
+    config.toJSON(doc, FieldList(fields.c_str()));
+    sendJSON(request, 200, doc);
 }
 
-void HTTPServer::handleSetConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    if (index + len != total) return;
-
+void HTTPServer::handleSetConfig(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::info("HTTPServer: POST /api/v1/config");
 
-    String jsonStr = String((char*)data);
+    if (doc.isNull()) {
+        sendError(request, 400, "Missing configuration body");
+        return;
+    }
 
-    if (config.fromJSON(jsonStr)) {
+    if (config.fromJSON(doc)) {
         config.save();
         sendSuccess(request, "Configuration updated successfully");
     } else {
@@ -471,37 +1243,37 @@ void HTTPServer::handleSetConfig(AsyncWebServerRequest* request, uint8_t* data,
 void HTTPServer::handleFactoryReset(AsyncWebServerRequest* request) {
     Logger::warning("HTTPServer: POST /api/v1/config/factory-reset");
 
-    sendSuccess(request, "Factory reset initiated. Device will restart.");
-
-    // Delay to send response, then reset
-    delay(500);
-
-    config.reset();
-    wifi.factoryReset();
+    bool scheduled = runAfterResponse(request, [this]() {
+        config.reset();
+        wifi.factoryReset();
+        ESP.restart();
+    });
+    if (!scheduled) {
+        sendError(request, 503, "Device busy, try again");
+        return;
+    }
 
-    delay(1000);
-    ESP.restart();
+    sendSuccess(request, "Factory reset initiated. Device will restart.");
 }
 
+#ifdef DEVICE_TYPE_PCR
+
 // ============================================================================
-// Program Management Endpoints
+// Program Management Endpoints (PCR)
 // ============================================================================
 
-void HTTPServer::handleProgramValidate(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    Logger::debug("HTTPServer: POST /api/v1/device/program/validate");
-
-    // Only process the final chunk
-    if (index + len != total) {
-        return;
-    }
+void HTTPServer::handleProgramTemplates(AsyncWebServerRequest* request) {
+    Logger::debug("HTTPServer: GET /api/v1/device/program/templates");
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
+    // Generated at build time and served from flash
+    static const FlashAsset catalog = { "application/json", (const uint8_t*)PROGRAM_TEMPLATES_JSON,
+                                        PROGRAM_TEMPLATES_JSON_LEN, PROGRAM_TEMPLATES_ETAG,
+                                        nullptr, "no-cache" };
+    sendCatalog(request, catalog);
+}
 
-    if (error) {
-        sendError(request, 400, "Invalid JSON: " + String(error.c_str()));
-        return;
-    }
+void HTTPServer::handleProgramValidate(AsyncWebServerRequest* request, JsonDocument& doc) {
+    Logger::debug("HTTPServer: POST /api/v1/device/program/validate");
 
     // Validation logic for PCR programs
     JsonArray errors = doc["errors"].to<JsonArray>();
@@ -549,6 +1321,13 @@ void HTTPServer::handleProgramValidate(AsyncWebServerRequest* request, uint8_t*
         }
     }
 
+    // Limits the device itself enforces on start (e.g. holdBand)
+    const char* invalid = device.checkParams(DeviceCommand::START, 0, 0, 0.0f, doc.as<JsonVariantConst>());
+    if (invalid) {
+        errors.add(invalid);
+        isValid = false;
+    }
+
     // Validate gradient parameters
     if (!doc["gradient"].isNull() && doc["gradient"]["enabled"]) {
         JsonObject grad = doc["gradient"];
@@ -578,105 +1357,9 @@ void HTTPServer::handleProgramValidate(AsyncWebServerRequest* request, uint8_t*
     sendJSON(request, 200, response);
 }
 
-void HTTPServer::handleProgramTemplates(AsyncWebServerRequest* request) {
-    Logger::debug("HTTPServer: GET /api/v1/device/program/templates");
+#endif // DEVICE_TYPE_PCR
 
-    JsonDocument doc;
-    JsonArray templates = doc["templates"].to<JsonArray>();
-
-    // Only provide PCR templates if device type is PCR
-    if (config.device.type == "PCR") {
-        // Standard PCR
-        JsonObject standard = templates.add<JsonObject>();
-        standard["name"] = "Standard PCR";
-        standard["type"] = "standard";
-        standard["description"] = "Basic PCR protocol for general amplification";
-        standard["cycles"] = 35;
-        standard["initialDenatureTemp"] = 95.0;
-        standard["initialDenatureTime"] = 180;   // 3 min
-        standard["denatureTemp"] = 95.0;
-        standard["denatureTime"] = 30;
-        standard["annealTemp"] = 55.0;
-        standard["annealTime"] = 30;
-        standard["extendTemp"] = 72.0;
-        standard["extendTime"] = 60;
-        standard["finalExtendTemp"] = 72.0;
-        standard["finalExtendTime"] = 300;       // 5 min
-
-        // Fast PCR (Two-Step)
-        JsonObject fast = templates.add<JsonObject>();
-        fast["name"] = "Fast PCR";
-        fast["type"] = "twostep";
-        fast["description"] = "Faster cycling for amplicons <500bp";
-        fast["twoStepEnabled"] = true;
-        fast["cycles"] = 30;
-        fast["initialDenatureTemp"] = 95.0;
-        fast["initialDenatureTime"] = 120;       // 2 min
-        fast["denatureTemp"] = 95.0;
-        fast["denatureTime"] = 15;
-        fast["annealExtendTemp"] = 68.0;
-        fast["annealExtendTime"] = 30;
-        fast["finalExtendTemp"] = 72.0;
-        fast["finalExtendTime"] = 180;
-
-        // Touchdown PCR (High Specificity)
-        JsonObject touchdown = templates.add<JsonObject>();
-        touchdown["name"] = "High Specificity";
-        touchdown["type"] = "touchdown";
-        touchdown["description"] = "Reduce non-specific amplification via touchdown";
-        touchdown["cycles"] = 35;
-        touchdown["initialDenatureTemp"] = 95.0;
-        touchdown["initialDenatureTime"] = 180;
-        touchdown["denatureTemp"] = 95.0;
-        touchdown["denatureTime"] = 30;
-        touchdown["extendTemp"] = 72.0;
-        touchdown["extendTime"] = 60;
-        touchdown["finalExtendTemp"] = 72.0;
-        touchdown["finalExtendTime"] = 300;
-        JsonObject tdConfig = touchdown["touchdown"].to<JsonObject>();
-        tdConfig["enabled"] = true;
-        tdConfig["startAnnealTemp"] = 65.0;
-        tdConfig["endAnnealTemp"] = 50.0;
-        tdConfig["stepSize"] = 1.0;
-        tdConfig["touchdownCycles"] = 15;
-
-        // Sensitive Detection (more cycles, lower anneal)
-        JsonObject sensitive = templates.add<JsonObject>();
-        sensitive["name"] = "Sensitive Detection";
-        sensitive["type"] = "standard";
-        sensitive["description"] = "More cycles for low-copy templates";
-        sensitive["cycles"] = 40;
-        sensitive["initialDenatureTemp"] = 95.0;
-        sensitive["initialDenatureTime"] = 180;
-        sensitive["denatureTemp"] = 95.0;
-        sensitive["denatureTime"] = 30;
-        sensitive["annealTemp"] = 50.0;
-        sensitive["annealTime"] = 45;
-        sensitive["extendTemp"] = 72.0;
-        sensitive["extendTime"] = 90;
-        sensitive["finalExtendTemp"] = 72.0;
-        sensitive["finalExtendTime"] = 300;
-
-        // Long Amplicon
-        JsonObject longAmp = templates.add<JsonObject>();
-        longAmp["name"] = "Long Amplicon";
-        longAmp["type"] = "standard";
-        longAmp["description"] = "Extended extension time for fragments >1 kb";
-        longAmp["cycles"] = 30;
-        longAmp["initialDenatureTemp"] = 95.0;
-        longAmp["initialDenatureTime"] = 240;
-        longAmp["denatureTemp"] = 95.0;
-        longAmp["denatureTime"] = 30;
-        longAmp["annealTemp"] = 55.0;
-        longAmp["annealTime"] = 30;
-        longAmp["extendTemp"] = 68.0;
-        longAmp["extendTime"] = 120;             // 2 min extension
-        longAmp["finalExtendTemp"] = 68.0;
-        longAmp["finalExtendTime"] = 600;        // 10 min
-    }
-
-    sendJSON(request, 200, doc);
-}
+#ifdef DEVICE_TYPE_INCUBATOR
 
 // ============================================================================
 // Protocol Management Endpoints (Incubator)
@@ -685,63 +1368,16 @@ void HTTPServer::handleProgramTemplates(AsyncWebServerRequest* request) {
 void HTTPServer::handleProtocolTemplates(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: GET /api/v1/device/protocol/templates");
 
-    JsonDocument doc;
-    JsonArray templates = doc["templates"].to<JsonArray>();
-
-    // Only provide incubator templates if device type is INCUBATOR
-    if (config.device.type == "INCUBATOR") {
-        // Mammalian Cell Culture
-        JsonObject mammalian = templates.add<JsonObject>();
-        mammalian["name"] = "Mammalian Cell Culture";
-        mammalian["type"] = 0; // MAMMALIAN_CULTURE
-        mammalian["description"] = "Standard mammalian cell culture with 30-minute pre-heat ramp";
-        mammalian["stages"] = 2;
-
-        // Bacterial Growth
-        JsonObject bacterial = templates.add<JsonObject>();
-        bacterial["name"] = "Bacterial Growth (E. coli)";
-        bacterial["type"] = 1; // BACTERIAL_CULTURE
-        bacterial["description"] = "Standard E. coli culture with 15-minute warm-up";
-        bacterial["stages"] = 2;
-
-        // Yeast Culture
-        JsonObject yeast = templates.add<JsonObject>();
-        yeast["name"] = "Yeast Culture";
-        yeast["type"] = 2; // YEAST_CULTURE
-        yeast["description"] = "Standard yeast culture at 30°C with 10-minute pre-heat";
-        yeast["stages"] = 2;
-
-        // Decontamination
-        JsonObject decon = templates.add<JsonObject>();
-        decon["name"] = "Decontamination Cycle";
-        decon["type"] = 3; // DECONTAMINATION
-        decon["description"] = "High-temperature cleaning cycle (65°C for 2 hours)";
-        decon["stages"] = 3;
-
-        // Multi-Temperature Expression
-        JsonObject multiTemp = templates.add<JsonObject>();
-        multiTemp["name"] = "Multi-Temperature Expression";
-        multiTemp["type"] = 4; // CUSTOM_PROTOCOL
-        multiTemp["description"] = "Three-stage protocol for protein expression optimization";
-        multiTemp["stages"] = 3;
-    }
-
-    sendJSON(request, 200, doc);
+    // Generated at build time and served from flash
+    static const FlashAsset catalog = { "application/json", (const uint8_t*)PROTOCOL_TEMPLATES_JSON,
+                                        PROTOCOL_TEMPLATES_JSON_LEN, PROTOCOL_TEMPLATES_ETAG,
+                                        nullptr, "no-cache" };
+    sendCatalog(request, catalog);
 }
 
-void HTTPServer::handleProtocolStart(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+void HTTPServer::handleProtocolStart(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::debug("HTTPServer: POST /api/v1/device/protocol/start");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Protocol management only available for incubator devices");
-        return;
-    }
-
-    // Only process the final chunk
-    if (index + len != total) {
-        return;
-    }
-
     // Note: This is a simplified implementation
     // In a full implementation, we would parse the protocol JSON and start it
     // For now, we just acknowledge receipt
@@ -751,11 +1387,6 @@ void HTTPServer::handleProtocolStart(AsyncWebServerRequest* request, uint8_t* da
 void HTTPServer::handleProtocolStop(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: POST /api/v1/device/protocol/stop");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Protocol management only available for incubator devices");
-        return;
-    }
-
     // Device-specific implementation would call device.stopProtocol()
     sendSuccess(request, "Protocol stopped");
 }
@@ -763,33 +1394,18 @@ void HTTPServer::handleProtocolStop(AsyncWebServerRequest* request) {
 void HTTPServer::handleProtocolPause(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: POST /api/v1/device/protocol/pause");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Protocol management only available for incubator devices");
-        return;
-    }
-
     sendSuccess(request, "Protocol paused");
 }
 
 void HTTPServer::handleProtocolResume(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: POST /api/v1/device/protocol/resume");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Protocol management only available for incubator devices");
-        return;
-    }
-
     sendSuccess(request, "Protocol resumed");
 }
 
 void HTTPServer::handleProtocolNextStage(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: POST /api/v1/device/protocol/next-stage");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Protocol management only available for incubator devices");
-        return;
-    }
-
     sendSuccess(request, "Advanced to next protocol stage");
 }
 
@@ -800,14 +1416,15 @@ void HTTPServer::handleProtocolNextStage(AsyncWebServerRequest* request) {
 void HTTPServer::handleGetAlarms(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: GET /api/v1/device/alarms");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Alarm management only available for incubator devices");
-        return;
+    // Pull just the alarms object out of the published status
+    JsonDocument statusDoc;
+    StatusSnapshot::FramePtr frame = device.getStatusSnapshot().get();
+    if (frame) {
+        JsonDocument filter;
+        filter["alarms"] = true;
+        deserializeJson(statusDoc, frame->json, DeserializationOption::Filter(filter));
     }
 
-    // Get alarm data from device status
-    JsonDocument statusDoc = device.getStatus();
-
     JsonDocument doc;
     if (statusDoc["alarms"].is<JsonObject>()) {
         doc["alarms"] = statusDoc["alarms"];
@@ -820,271 +1437,86 @@ void HTTPServer::handleGetAlarms(AsyncWebServerRequest* request) {
     sendJSON(request, 200, doc);
 }
 
-void HTTPServer::handleAcknowledgeAlarm(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+void HTTPServer::handleAcknowledgeAlarm(AsyncWebServerRequest* request, JsonDocument& doc) {
     Logger::debug("HTTPServer: POST /api/v1/device/alarms/acknowledge");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Alarm management only available for incubator devices");
-        return;
-    }
-
-    // Only process the final chunk
-    if (index + len != total) {
-        return;
-    }
-
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, data, len);
-
-    if (error) {
-        sendError(request, 400, "Invalid JSON");
-        return;
-    }
-
     if (!doc["index"].is<uint8_t>()) {
         sendError(request, 400, "Missing or invalid 'index' field");
         return;
     }
 
-    sendSuccess(request, "Alarm acknowledged");
+    // Index into alarms.active of the status; applied on the next control tick
+    DeviceCommand command;
+    command.type = DeviceCommand::ACK_ALARM;
+    command.zone = doc["index"];
+    submitCommand(request, command);
 }
 
 void HTTPServer::handleAcknowledgeAllAlarms(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: POST /api/v1/device/alarms/acknowledge-all");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Alarm management only available for incubator devices");
-        return;
-    }
-
-    sendSuccess(request, "All alarms acknowledged");
+    DeviceCommand command;
+    command.type = DeviceCommand::ACK_ALL_ALARMS;
+    submitCommand(request, command);
 }
 
 void HTTPServer::handleGetAlarmHistory(AsyncWebServerRequest* request) {
     Logger::debug("HTTPServer: GET /api/v1/device/alarms/history");
 
-    if (config.device.type != "INCUBATOR") {
-        sendError(request, 400, "Alarm management only available for incubator devices");
+    const AlarmHistory* history = device.getAlarmHistory();
+    if (!history) {
+        sendError(request, 404, "Alarm history not available");
         return;
     }
 
-    JsonDocument doc;
-    doc["history"].to<JsonArray>();
-    // Alarm history would come from device implementation
-
-    sendJSON(request, 200, doc);
-}
+    // ?after=<seq> is the "next" of the previous page; 0 (default) starts at the oldest kept
+    uint32_t after = 0;
+    uint8_t limit = ALARM_HISTORY_PAGE_MAX;
+    if (request->hasParam("after")) {
+        after = strtoul(request->getParam("after")->value().c_str(), nullptr, 10);
+    }
+    if (request->hasParam("limit")) {
+        long value = request->getParam("limit")->value().toInt();
+        if (value < 1 || value > ALARM_HISTORY_PAGE_MAX) {
+            sendError(request, 400, "'limit' must be 1-" + String(ALARM_HISTORY_PAGE_MAX));
+            return;
+        }
+        limit = value;
+    }
 
-// ============================================================================
-// Provisioning Page
-// ============================================================================
+    AlarmHistory::Exporter exporter(*history, after, limit);
 
-void HTTPServer::handleProvisioningPage(AsyncWebServerRequest* request) {
-    Logger::debug("HTTPServer: GET / (provisioning page)");
-
-    String html = R"html(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Axionyx Device Setup</title>
-    <style>
-        * { margin: 0; padding: 0; box-sizing: border-box; }
-        body {
-            font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            min-height: 100vh;
-            display: flex;
-            align-items: center;
-            justify-content: center;
-            padding: 20px;
-        }
-        .container {
-            background: white;
-            border-radius: 20px;
-            box-shadow: 0 20px 60px rgba(0,0,0,0.3);
-            max-width: 400px;
-            width: 100%;
-            padding: 40px 30px;
+    if (acceptsMsgPack(request)) {
+        // A page is at most ALARM_HISTORY_PAGE_MAX records, so it is rendered
+        // whole and converted, as the catalogs are
+        String json;
+        uint8_t piece[128];
+        size_t n;
+        while ((n = exporter.read(piece, sizeof(piece))) > 0) {
+            json.concat((const char*)piece, n);
         }
-        h1 {
-            color: #667eea;
-            font-size: 28px;
-            margin-bottom: 10px;
-            text-align: center;
-        }
-        .subtitle {
-            color: #666;
-            text-align: center;
-            margin-bottom: 30px;
-            font-size: 14px;
-        }
-        .device-info {
-            background: #f8f9fa;
-            border-radius: 10px;
-            padding: 15px;
-            margin-bottom: 25px;
-        }
-        .device-info-item {
-            display: flex;
-            justify-content: space-between;
-            margin-bottom: 8px;
-            font-size: 14px;
-        }
-        .device-info-item:last-child { margin-bottom: 0; }
-        .device-info-label { color: #666; }
-        .device-info-value { color: #333; font-weight: 600; }
-        .form-group {
-            margin-bottom: 20px;
-        }
-        label {
-            display: block;
-            color: #333;
-            font-weight: 600;
-            margin-bottom: 8px;
-            font-size: 14px;
-        }
-        input, select {
-            width: 100%;
-            padding: 12px 15px;
-            border: 2px solid #e0e0e0;
-            border-radius: 10px;
-            font-size: 15px;
-            transition: border-color 0.3s;
-        }
-        input:focus, select:focus {
-            outline: none;
-            border-color: #667eea;
-        }
-        button {
-            width: 100%;
-            padding: 14px;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-            border: none;
-            border-radius: 10px;
-            font-size: 16px;
-            font-weight: 600;
-            cursor: pointer;
-            transition: transform 0.2s, box-shadow 0.2s;
-        }
-        button:hover {
-            transform: translateY(-2px);
-            box-shadow: 0 10px 20px rgba(102, 126, 234, 0.4);
-        }
-        button:active {
-            transform: translateY(0);
-        }
-        .message {
-            padding: 12px;
-            border-radius: 8px;
-            margin-top: 20px;
-            text-align: center;
-            font-size: 14px;
-            display: none;
-        }
-        .message.success {
-            background: #d4edda;
-            color: #155724;
-            border: 1px solid #c3e6cb;
-        }
-        .message.error {
-            background: #f8d7da;
-            color: #721c24;
-            border: 1px solid #f5c6cb;
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>)html" + config.device.type + R"html( Setup</h1>
-        <p class="subtitle">Configure your device's WiFi connection</p>
-
-        <div class="device-info">
-            <div class="device-info-item">
-                <span class="device-info-label">Device ID:</span>
-                <span class="device-info-value">)html" + config.device.id + R"html(</span>
-            </div>
-            <div class="device-info-item">
-                <span class="device-info-label">Type:</span>
-                <span class="device-info-value">)html" + config.device.type + R"html(</span>
-            </div>
-            <div class="device-info-item">
-                <span class="device-info-label">Firmware:</span>
-                <span class="device-info-value">)html" + config.device.firmwareVersion + R"html(</span>
-            </div>
-        </div>
-
-        <form id="wifiForm">
-            <div class="form-group">
-                <label for="ssid">WiFi Network</label>
-                <input type="text" id="ssid" name="ssid" placeholder="Enter WiFi network name" required>
-                <small style="color: #666; font-size: 12px;">Enter the exact name of your WiFi network</small>
-            </div>
-
-            <div class="form-group">
-                <label for="password">Password</label>
-                <input type="password" id="password" name="password" placeholder="Enter password" required>
-            </div>
-
-            <div class="form-group">
-                <label for="mode">Connection Mode</label>
-                <select id="mode" name="mode">
-                    <option value="1">WiFi Only</option>
-                    <option value="2">WiFi + Hotspot</option>
-                </select>
-            </div>
-
-            <button type="submit">Connect to WiFi</button>
-        </form>
-
-        <div id="message" class="message"></div>
-    </div>
-
-    <script>
-        document.getElementById('wifiForm').addEventListener('submit', async (e) => {
-            e.preventDefault();
-
-            const formData = {
-                ssid: document.getElementById('ssid').value,
-                password: document.getElementById('password').value,
-                mode: parseInt(document.getElementById('mode').value)
-            };
-
-            try {
-                const response = await fetch('/api/v1/wifi/configure', {
-                    method: 'POST',
-                    headers: { 'Content-Type': 'application/json' },
-                    body: JSON.stringify(formData)
-                });
+        JsonDocument doc;
+        deserializeJson(doc, json);
+        json = String();
 
-                const data = await response.json();
+        AsyncWebServerResponse* response = beginJSON(request, 200, doc);
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
+        return;
+    }
 
-                if (data.success) {
-                    showMessage('WiFi configured! Device is connecting...', 'success');
-                    setTimeout(() => {
-                        showMessage('You can now close this page', 'success');
-                    }, 3000);
-                } else {
-                    showMessage('Configuration failed: ' + data.error, 'error');
-                }
-            } catch (error) {
-                showMessage('Failed to configure WiFi', 'error');
-            }
-        });
+    metrics.end(request, 200, 0);
 
-        function showMessage(text, type) {
-            const messageDiv = document.getElementById('message');
-            messageDiv.textContent = text;
-            messageDiv.className = 'message ' + type;
-            messageDiv.style.display = 'block';
-        }
-    </script>
-</body>
-</html>
-)html";
+    // Records are copied out of the log one at a time while the response goes out
+    AsyncWebServerResponse* response = request->beginChunkedResponse(CONTENT_TYPE_JSON,
+        [exporter](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+            return exporter.read(buffer, maxLen);
+        });
 
-    AsyncWebServerResponse* response = request->beginResponse(200, "text/html", html);
+    response->addHeader("Cache-Control", "no-store");
+    response->addHeader("Vary", "Accept");
+    enableCORS(response);
     request->send(response);
 }
+
+#endif // DEVICE_TYPE_INCUBATOR
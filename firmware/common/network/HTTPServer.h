@@ -9,51 +9,192 @@
 
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
+#include <memory>
+#include <functional>
 #include "../config/Config.h"
 #include "../wifi/WiFiManager.h"
 #include "../device/DeviceBase.h"
+#include "../utils/CriticalSection.h"
+#include "../utils/DeferredActions.h"
+#include "RequestBodyPool.h"
+#include "FlashAssetHandler.h"
+#include "ApiMetrics.h"
+#include "AdmissionControl.h"
+
+// Number of request bodies that can be collected concurrently
+#ifndef HTTP_BODY_POOL_SLOTS
+#define HTTP_BODY_POOL_SLOTS 2
+#endif
+
+// Telemetry stream (/device/stream) clients served at once
+#ifndef HTTP_STREAM_MAX_CLIENTS
+#define HTTP_STREAM_MAX_CLIENTS 4
+#endif
+
+// How long a device command may wait for the control loop before a 504
+#ifndef HTTP_COMMAND_TIMEOUT_MS
+#define HTTP_COMMAND_TIMEOUT_MS 2000
+#endif
 
 class HTTPServer {
 public:
-    HTTPServer(DeviceConfig& config, DeviceBase& device, WiFiManager& wifi);
+    HTTPServer(DeviceConfig& config, DeviceBase& device, WiFiManager& wifi, DeferredActions& deferred,
+               ApiMetrics& metrics, AdmissionControl& admission);
     ~HTTPServer();
 
     void begin();
     void loop();
 
+    // Hand the latest serialized telemetry message to the /device/stream
+    // clients; id is the seq of its newest sample. The message is shared with
+    // the WebSocket broadcast, not copied, and written from the network task.
+    void streamTelemetry(const std::shared_ptr<const String>& message, uint32_t id);
+
+    // Whether any /device/stream client is connected. While none is, the
+    // message kept for clients that connect is let go, as it would go stale.
+    bool wantsTelemetry();
+
+    // Builds the JSON "replay" message for a stream client resuming after
+    // sample since (Last-Event-ID) and returns the seq it reaches. Called
+    // from loop().
+    typedef std::function<uint32_t(uint32_t since, String& out)> ReplaySource;
+    void onReplay(ReplaySource source) { replaySource = source; }
+
 private:
     DeviceConfig& config;
     DeviceBase& device;
     WiFiManager& wifi;
+    DeferredActions& deferred;
+    ApiMetrics& metrics;
+    AdmissionControl& admission;
     AsyncWebServer* server;
     bool serverStarted;
+    RequestBodyPool bodyPool;
+    uint32_t heapLowWater;    // Lowest free heap seen while sending a response
+    ApiMetrics::Endpoint metricsBase;   // Metrics endpoint of the first route
+
+    // A device command waiting for its result from the control loop. loop()
+    // fills in the result; the response is built from it (see below).
+    struct PendingCommand {
+        uint32_t id;                        // 0 when the slot is free
+        AsyncWebServerRequest* request;     // Owner, only compared (see abandonCommand)
+        DeviceCommand::Type type;
+        unsigned long submittedAt;
+        bool ready;                         // Result posted (or timed out)
+        bool timedOut;
+        bool success;
+        JsonDocument data;                  // BATCH: per-operation results
+    };
+
+    PendingCommand pendingCommands[COMMAND_QUEUE_DEPTH];
+    CriticalMutex pendingMux = CRITICAL_MUTEX_INIT;
+    uint32_t nextCommandId;
+
+    // Server-Sent Events telemetry. loop() only leaves messages here; each
+    // client's StreamResponse writes them out from the network task.
+    struct StreamClient {
+        bool active;
+        uint32_t session;                       // Tells reuses of the slot apart
+        bool resuming;                          // Waiting for loop() to build a replay page
+        uint32_t resumeSince;
+        std::shared_ptr<const String> replay;   // Built page, not written yet
+        uint32_t replayNext;
+    };
+
+    std::shared_ptr<const String> latestTelemetry;
+    uint32_t latestTelemetryId;
+    StreamClient streamClients[HTTP_STREAM_MAX_CLIENTS];
+    uint8_t streamCount;
+    uint32_t nextStreamSession;
+    CriticalMutex telemetryMux = CRITICAL_MUTEX_INIT;
+    ReplaySource replaySource;
+    void replayStreams();
+
+    // Route handlers; body handlers get the collected and parsed JSON body
+    typedef void (HTTPServer::*RequestHandler)(AsyncWebServerRequest* request);
+    typedef void (HTTPServer::*BodyHandler)(AsyncWebServerRequest* request, JsonDocument& body);
+
+    // One REST endpoint; exactly one of handler/bodyHandler is set
+    struct Route {
+        uint8_t method;             // WebRequestMethod
+        const char* path;           // Relative to /api/v1
+        uint32_t key;               // routeKey(method, path)
+        RequestHandler handler;
+        BodyHandler bodyHandler;
+    };
+
+    struct Routes;                  // Compile-time route table (HTTPServer.cpp)
+    class ApiRouter;                // Single AsyncWebHandler for all of /api/v1
+#ifdef ESP32
+    class CommandResponse;          // Waits for a device command result (HTTPServer.cpp)
+#endif
+    class StreamHandler;            // GET /device/stream
+    class StreamResponse;           // One open telemetry stream
 
     // Setup routes
     void setupRoutes();
+    void registerMetrics();
 
     // CORS and response helpers
     void enableCORS(AsyncWebServerResponse* response);
     void sendJSON(AsyncWebServerRequest* request, int code, const JsonDocument& doc);
+    AsyncWebServerResponse* beginJSON(AsyncWebServerRequest* request, int code, const JsonDocument& doc);
+
+    // Documents go out as MessagePack when the client sends Accept: application/msgpack
+    static bool acceptsMsgPack(AsyncWebServerRequest* request);
+    AsyncResponseStream* beginDocument(AsyncWebServerRequest* request, const JsonDocument& doc, size_t& length);
+    void sendCatalog(AsyncWebServerRequest* request, const FlashAsset& catalog);
     void sendError(AsyncWebServerRequest* request, int code, const String& error);
     void sendSuccess(AsyncWebServerRequest* request, const String& message);
+    void sendRejected(AsyncWebServerRequest* request, AdmissionControl::Verdict verdict, uint32_t retryAfter);
+
+    // Request body helpers
+    void collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void dispatchBody(AsyncWebServerRequest* request, BodyHandler handler);
+
+    // Run action from loop() once the response has gone out (client disconnected),
+    // or after AFTER_RESPONSE_TIMEOUT_MS at the latest; false if it could not be scheduled
+    bool runAfterResponse(AsyncWebServerRequest* request, DeferredActions::Action action);
+
+    static const uint32_t AFTER_RESPONSE_TIMEOUT_MS = 2000;
+    static const uint32_t AFTER_RESPONSE_GRACE_MS = 100;
+
+    // Device command helpers. loop() posts each result to its slot. On the
+    // ESP32 the request's CommandResponse picks it up from the network task;
+    // on the ESP8266 loop() shares that thread and sends it straight away.
+    void submitCommand(AsyncWebServerRequest* request, DeviceCommand& command);
+    void abandonCommand(AsyncWebServerRequest* request);
+    void completeCommands();
+    void postResult(uint32_t id, CommandResult* result);
+#ifndef ESP32
+    void sendReadyCommands();
+#endif
+    AsyncWebServerResponse* takeCommandResponse(AsyncWebServerRequest* request, uint32_t id);
+    PendingCommand* findPending(uint32_t id);
+    PendingCommand* findPending(AsyncWebServerRequest* request);
+    static int describeResult(DeviceCommand::Type type, bool success, JsonDocument& doc);
 
     // Route handlers - Device Management
     void handleGetDeviceInfo(AsyncWebServerRequest* request);
     void handleGetDeviceStatus(AsyncWebServerRequest* request);
-    void handleDeviceStart(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleDeviceStart(AsyncWebServerRequest* request, JsonDocument& doc);
     void handleDeviceStop(AsyncWebServerRequest* request);
     void handleDevicePause(AsyncWebServerRequest* request);
     void handleDeviceResume(AsyncWebServerRequest* request);
-    void handleSetSetpoint(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
-    void handleDeviceTest(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleSetSetpoint(AsyncWebServerRequest* request, JsonDocument& doc);
+    void handleDeviceTest(AsyncWebServerRequest* request, JsonDocument& doc);
+    void handleBatch(AsyncWebServerRequest* request, JsonDocument& doc);
 
+#ifdef DEVICE_TYPE_PCR
     // Route handlers - Program Management (PCR)
-    void handleProgramValidate(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
     void handleProgramTemplates(AsyncWebServerRequest* request);
+    void handleProgramValidate(AsyncWebServerRequest* request, JsonDocument& doc);
+#endif
 
+#ifdef DEVICE_TYPE_INCUBATOR
     // Route handlers - Protocol Management (Incubator)
     void handleProtocolTemplates(AsyncWebServerRequest* request);
-    void handleProtocolStart(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleProtocolStart(AsyncWebServerRequest* request, JsonDocument& doc);
     void handleProtocolStop(AsyncWebServerRequest* request);
     void handleProtocolPause(AsyncWebServerRequest* request);
     void handleProtocolResume(AsyncWebServerRequest* request);
@@ -61,21 +202,22 @@ private:
 
     // Route handlers - Alarm Management (Incubator)
     void handleGetAlarms(AsyncWebServerRequest* request);
-    void handleAcknowledgeAlarm(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleAcknowledgeAlarm(AsyncWebServerRequest* request, JsonDocument& doc);
     void handleAcknowledgeAllAlarms(AsyncWebServerRequest* request);
     void handleGetAlarmHistory(AsyncWebServerRequest* request);
+#endif
+
+    // Route handlers - Metrics
+    void handleGetMetrics(AsyncWebServerRequest* request);
 
     // Route handlers - WiFi Configuration
     void handleGetWiFiStatus(AsyncWebServerRequest* request);
-    void handleWiFiConfigure(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleWiFiConfigure(AsyncWebServerRequest* request, JsonDocument& doc);
 
     // Route handlers - Configuration
     void handleGetConfig(AsyncWebServerRequest* request);
-    void handleSetConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleSetConfig(AsyncWebServerRequest* request, JsonDocument& doc);
     void handleFactoryReset(AsyncWebServerRequest* request);
-
-    // Provisioning page (captive portal)
-    void handleProvisioningPage(AsyncWebServerRequest* request);
 };
 
 #endif // HTTP_SERVER_H
@@ -0,0 +1,164 @@
+/**
+ * RequestBodyPool.cpp
+ * Fixed-size pool of request body buffers implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "RequestBodyPool.h"
+#include "../utils/Logger.h"
+
+RequestBodyPool::RequestBodyPool()
+    : slots(nullptr), slotCount(0), slotSize(0), onDemand(false) {
+}
+
+RequestBodyPool::~RequestBodyPool() {
+    if (slots) {
+        for (uint8_t i = 0; i < slotCount; i++) {
+            free(slots[i].buffer);
+        }
+        delete[] slots;
+    }
+}
+
+bool RequestBodyPool::begin(uint8_t count, size_t size, bool allocateOnDemand) {
+    if (slots) {
+        return true;
+    }
+
+    slots = new Slot[count];
+    slotCount = count;
+    slotSize = size;
+    onDemand = allocateOnDemand;
+
+    bool ok = true;
+    for (uint8_t i = 0; i < slotCount; i++) {
+        slots[i].owner = nullptr;
+        slots[i].length = 0;
+        slots[i].claimedAt = 0;
+        slots[i].buffer = nullptr;
+        if (onDemand) continue;
+
+        // One extra byte so the collected body is always NUL-terminated
+        slots[i].buffer = (char*)malloc(slotSize + 1);
+        if (!slots[i].buffer) {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        Logger::error("RequestBodyPool: Failed to allocate body buffers");
+    }
+    return ok;
+}
+
+RequestBodyPool::Result RequestBodyPool::append(const void* owner, const uint8_t* data, size_t len,
+                                                size_t index, size_t total) {
+    if (total > slotSize || index + len > slotSize) {
+        release(owner);
+        return BODY_TOO_LARGE;
+    }
+
+    Slot* slot = find(owner);
+    if (!slot) {
+        if (index != 0) {
+            return BODY_OUT_OF_ORDER;
+        }
+        slot = claim(owner);
+        if (!slot) {
+            return BODY_NO_SLOT;
+        }
+    } else if (index == 0) {
+        slot->length = 0;
+    }
+
+    if (index != slot->length) {
+        release(owner);
+        return BODY_OUT_OF_ORDER;
+    }
+
+    memcpy(slot->buffer + index, data, len);
+    slot->length = index + len;
+    slot->buffer[slot->length] = '\0';
+    return BODY_OK;
+}
+
+char* RequestBodyPool::get(const void* owner, size_t& len) {
+    Slot* slot = find(owner);
+    if (!slot) {
+        len = 0;
+        return nullptr;
+    }
+
+    len = slot->length;
+    return slot->buffer;
+}
+
+void RequestBodyPool::release(const void* owner) {
+    Slot* slot = find(owner);
+    if (slot) {
+        slot->owner = nullptr;
+        slot->length = 0;
+        if (onDemand) {
+            free(slot->buffer);
+            slot->buffer = nullptr;
+        }
+    }
+}
+
+uint8_t RequestBodyPool::slotsInUse() const {
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < slotCount; i++) {
+        if (slots[i].owner) used++;
+    }
+    return used;
+}
+
+RequestBodyPool::Slot* RequestBodyPool::find(const void* owner) {
+    if (!owner) return nullptr;
+
+    for (uint8_t i = 0; i < slotCount; i++) {
+        if (slots[i].owner == owner) {
+            return &slots[i];
+        }
+    }
+    return nullptr;
+}
+
+RequestBodyPool::Slot* RequestBodyPool::claim(const void* owner) {
+    unsigned long now = millis();
+    Slot* stale = nullptr;
+
+    for (uint8_t i = 0; i < slotCount; i++) {
+        // Up front, a slot whose buffer could not be allocated is never used
+        if (!slots[i].buffer && !onDemand) continue;
+
+        if (!slots[i].owner) {
+            stale = &slots[i];
+            break;
+        }
+        if (!stale && now - slots[i].claimedAt > SLOT_TIMEOUT_MS) {
+            stale = &slots[i];
+        }
+    }
+
+    if (!stale) {
+        return nullptr;
+    }
+
+    if (stale->owner) {
+        Logger::warning("RequestBodyPool: Reclaiming abandoned body buffer");
+    }
+    if (!stale->buffer) {
+        stale->buffer = (char*)malloc(slotSize + 1);
+        if (!stale->buffer) {
+            Logger::warning("RequestBodyPool: No memory for a body buffer");
+            stale->owner = nullptr;
+            return nullptr;
+        }
+    }
+
+    stale->owner = owner;
+    stale->length = 0;
+    stale->claimedAt = now;
+    return stale;
+}
@@ -0,0 +1,63 @@
+/**
+ * RequestBodyPool.h
+ * Fixed-size pool of request body buffers
+ * Collects chunked bodies so they can be parsed once when complete
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef REQUEST_BODY_POOL_H
+#define REQUEST_BODY_POOL_H
+
+#include <Arduino.h>
+
+class RequestBodyPool {
+public:
+    // Result of appending a chunk
+    enum Result {
+        BODY_OK = 0,          // Chunk stored
+        BODY_TOO_LARGE = 1,   // Body exceeds slot capacity
+        BODY_NO_SLOT = 2,     // All slots are in use
+        BODY_OUT_OF_ORDER = 3 // Chunk offset does not follow the stored data
+    };
+
+    RequestBodyPool();
+    ~RequestBodyPool();
+
+    // Allocate all slot buffers up front; returns false if allocation failed.
+    // With onDemand a slot's buffer is only allocated while it is claimed,
+    // for bodies too rare to keep memory for (a claim fails if malloc does).
+    bool begin(uint8_t slotCount, size_t slotSize, bool onDemand = false);
+
+    // Append a chunk for the given owner (total = 0 when the size is unknown)
+    Result append(const void* owner, const uint8_t* data, size_t len, size_t index, size_t total);
+
+    // Buffer collected for owner (NUL-terminated), or nullptr if none
+    char* get(const void* owner, size_t& len);
+
+    // Return the owner's slot to the pool (no-op if it holds none)
+    void release(const void* owner);
+
+    size_t capacity() const { return slotSize; }
+    uint8_t slotsInUse() const;
+
+private:
+    struct Slot {
+        const void* owner;
+        char* buffer;
+        size_t length;
+        unsigned long claimedAt;
+    };
+
+    Slot* slots;
+    uint8_t slotCount;
+    size_t slotSize;
+    bool onDemand;
+
+    // Slots held longer than this are assumed abandoned and may be reclaimed
+    static const unsigned long SLOT_TIMEOUT_MS = 10000;
+
+    Slot* find(const void* owner);
+    Slot* claim(const void* owner);
+};
+
+#endif // REQUEST_BODY_POOL_H
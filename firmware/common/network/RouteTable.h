@@ -0,0 +1,103 @@
+/**
+ * RouteTable.h
+ * Compile-time perfect hash over a constexpr route list
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <Arduino.h>
+#include "../utils/Hash.h"
+
+// Key for a (method, path) pair; path is relative to the API prefix
+constexpr uint32_t routeKey(uint8_t method, const char* path) {
+    return Hash::fnv1a(path, Hash::FNV_OFFSET ^ method);
+}
+
+namespace RouteHash {
+    template <size_t... I> struct IndexSeq {};
+    template <size_t N, size_t... I> struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+    template <size_t... I> struct MakeIndexSeq<0, I...> { typedef IndexSeq<I...> type; };
+
+    static constexpr uint8_t NO_ROUTE = 0xFF;
+    static constexpr uint32_t MAX_SEED = 250;
+
+    constexpr uint16_t slot(uint32_t key, uint32_t seed, uint8_t bits) {
+        return Hash::mix(key, seed) >> (32 - bits);
+    }
+
+    // Everything below is plain recursion so it stays valid C++11 constexpr
+
+    template <typename R>
+    constexpr bool distinctFrom(const R* routes, size_t n, size_t i, size_t j, uint32_t seed, uint8_t bits) {
+        return j >= n ? true
+             : slot(routes[i].key, seed, bits) != slot(routes[j].key, seed, bits) &&
+               distinctFrom(routes, n, i, j + 1, seed, bits);
+    }
+
+    template <typename R>
+    constexpr bool allDistinct(const R* routes, size_t n, size_t i, uint32_t seed, uint8_t bits) {
+        return i >= n ? true
+             : distinctFrom(routes, n, i, i + 1, seed, bits) && allDistinct(routes, n, i + 1, seed, bits);
+    }
+
+    // First seed that places every route in its own slot, or 0 if none up to MAX_SEED
+    template <typename R>
+    constexpr uint32_t findSeed(const R* routes, size_t n, uint8_t bits, uint32_t seed = 1) {
+        return seed > MAX_SEED ? 0
+             : allDistinct(routes, n, 0, seed, bits) ? seed
+             : findSeed(routes, n, bits, seed + 1);
+    }
+
+    template <typename R>
+    constexpr uint8_t routeInSlot(const R* routes, size_t n, uint16_t s, uint32_t seed, uint8_t bits, size_t i = 0) {
+        return i >= n ? NO_ROUTE
+             : slot(routes[i].key, seed, bits) == s ? (uint8_t)i
+             : routeInSlot(routes, n, s, seed, bits, i + 1);
+    }
+
+    template <size_t SIZE>
+    struct SlotArray {
+        uint8_t index[SIZE];
+    };
+
+    template <size_t SIZE, typename R, size_t... I>
+    constexpr SlotArray<SIZE> buildSlots(const R* routes, size_t n, uint32_t seed, uint8_t bits, IndexSeq<I...>) {
+        return SlotArray<SIZE>{{ routeInSlot(routes, n, I, seed, bits)... }};
+    }
+}
+
+/**
+ * Routes must be a type with `static constexpr R TABLE[]` (R has a uint32_t
+ * `key` member built with routeKey()) and `static constexpr size_t COUNT`.
+ * The seed and the slot -> route index array are worked out by the compiler;
+ * a lookup is one hash, one array read and one key compare.
+ */
+template <typename Routes, uint8_t BITS>
+struct RouteTable {
+    static constexpr size_t SIZE = (size_t)1 << BITS;
+    static constexpr uint32_t SEED = RouteHash::findSeed(Routes::TABLE, Routes::COUNT, BITS);
+
+    static_assert(Routes::COUNT < RouteHash::NO_ROUTE, "Too many routes for an 8-bit slot index");
+    static_assert(SEED != 0, "No collision-free seed found; increase the route table size");
+
+    static constexpr RouteHash::SlotArray<SIZE> SLOTS =
+        RouteHash::buildSlots<SIZE>(Routes::TABLE, Routes::COUNT, SEED, BITS,
+                                    typename RouteHash::MakeIndexSeq<SIZE>::type());
+
+    // Route index for key, or -1. The caller must still compare the path,
+    // since any unknown path also hashes into some slot.
+    static int find(uint32_t key) {
+        uint8_t index = SLOTS.index[RouteHash::slot(key, SEED, BITS)];
+        if (index == RouteHash::NO_ROUTE || Routes::TABLE[index].key != key) {
+            return -1;
+        }
+        return index;
+    }
+};
+
+template <typename Routes, uint8_t BITS>
+constexpr RouteHash::SlotArray<RouteTable<Routes, BITS>::SIZE> RouteTable<Routes, BITS>::SLOTS;
+
+#endif // ROUTE_TABLE_H
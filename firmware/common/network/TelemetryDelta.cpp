@@ -0,0 +1,133 @@
+/**
+ * TelemetryDelta.cpp
+ * Telemetry delta implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "TelemetryDelta.h"
+
+namespace {
+    // Sensor noise and countdowns that would otherwise change every tick.
+    // Keyed by field name at any depth; fields not listed use 0 (any change).
+    struct FieldEpsilon {
+        const char* key;
+        float epsilon;
+    };
+
+    const FieldEpsilon FIELD_EPSILONS[] = {
+        { "uptime",             10.0f },
+        { "temperature",        0.1f },
+        { "temperatureError",   0.1f },
+        { "humidity",           0.5f },
+        { "humidityError",      0.5f },
+        { "co2Level",           0.05f },
+        { "co2Error",           0.05f },
+        { "progress",           0.5f },
+        { "phaseTimeRemaining", 5.0f },
+        { "totalTimeRemaining", 5.0f },
+        { "eta",                5.0f },
+        { "stageTimeRemaining", 5.0f },
+        { "rampTime",           5.0f },
+        { "holdTime",           5.0f },
+        { "timeStable",         5.0f }
+    };
+}
+
+float TelemetryDelta::epsilonFor(const char* key) {
+    for (const FieldEpsilon& field : FIELD_EPSILONS) {
+        if (strcmp(key, field.key) == 0) {
+            return field.epsilon;
+        }
+    }
+    return 0.0f;
+}
+
+bool TelemetryDelta::update(const JsonDocument& status, JsonObject changes) {
+    if (!baseline.is<JsonObject>()) {
+        return false;
+    }
+    return diffObject(baseline.as<JsonObject>(), status.as<JsonObjectConst>(), changes);
+}
+
+void TelemetryDelta::rebase(const JsonDocument& status) {
+    baseline.set(status);
+}
+
+void TelemetryDelta::reset() {
+    baseline.clear();
+}
+
+bool TelemetryDelta::diffObject(JsonObject base, JsonObjectConst current, JsonObject changes) {
+    // A field that went away cannot be expressed as a change; resend everything
+    for (JsonPair field : base) {
+        if (current[field.key()].isNull()) {
+            return false;
+        }
+    }
+
+    for (JsonPairConst field : current) {
+        const char* key = field.key().c_str();
+        JsonVariant before = base[key];
+        JsonVariantConst after = field.value();
+
+        // Nested objects are diffed member by member, so only what moved is sent
+        if (after.is<JsonObjectConst>() && before.is<JsonObject>()) {
+            JsonObject nested = changes[key].to<JsonObject>();
+            if (!diffObject(before.as<JsonObject>(), after.as<JsonObjectConst>(), nested)) {
+                return false;
+            }
+            if (nested.size() == 0) {
+                changes.remove(key);
+            }
+            continue;
+        }
+
+        if (differs(before, after, epsilonFor(key))) {
+            changes[key] = after;
+            base[key] = after;
+        }
+    }
+    return true;
+}
+
+bool TelemetryDelta::differs(JsonVariantConst before, JsonVariantConst after, float epsilon) {
+    if (before.isNull()) {
+        return !after.isNull();
+    }
+
+    if (before.is<JsonObjectConst>() && after.is<JsonObjectConst>()) {
+        JsonObjectConst a = before.as<JsonObjectConst>();
+        JsonObjectConst b = after.as<JsonObjectConst>();
+        if (a.size() != b.size()) {
+            return true;
+        }
+        for (JsonPairConst field : b) {
+            if (differs(a[field.key()], field.value(), epsilonFor(field.key().c_str()))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Arrays go out whole if any element moved (e.g. per-zone temperatures)
+    if (before.is<JsonArrayConst>() && after.is<JsonArrayConst>()) {
+        JsonArrayConst a = before.as<JsonArrayConst>();
+        JsonArrayConst b = after.as<JsonArrayConst>();
+        if (a.size() != b.size()) {
+            return true;
+        }
+        for (size_t i = 0; i < b.size(); i++) {
+            if (differs(a[i], b[i], epsilon)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (epsilon > 0.0f && !before.is<bool>() && !after.is<bool>() &&
+        before.is<float>() && after.is<float>()) {
+        return fabs(before.as<float>() - after.as<float>()) >= epsilon;
+    }
+
+    return before != after;
+}
@@ -0,0 +1,47 @@
+/**
+ * TelemetryDelta.h
+ * Computes telemetry deltas against the state delta clients already hold
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef TELEMETRY_DELTA_H
+#define TELEMETRY_DELTA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Telemetry messages between full keyframes sent to delta clients
+#ifndef TELEMETRY_KEYFRAME_INTERVAL
+#define TELEMETRY_KEYFRAME_INTERVAL 30
+#endif
+
+/**
+ * Keeps the baseline: the status as delta clients reconstruct it from the
+ * last keyframe plus every delta since. Changes are measured against that,
+ * not against the previous status, so a value creeping by less than its
+ * epsilon each tick is still sent once it has drifted far enough.
+ */
+class TelemetryDelta {
+public:
+    // Fill changes with the fields that moved beyond their epsilon and fold them
+    // into the baseline. Returns false if a keyframe is needed instead: no
+    // baseline yet, or a field disappeared.
+    bool update(const JsonDocument& status, JsonObject changes);
+
+    // A keyframe went out; clients now hold exactly this status
+    void rebase(const JsonDocument& status);
+
+    // Drop the baseline (no delta clients left)
+    void reset();
+
+    // Smallest change worth sending for a field, by name; 0 means any change
+    static float epsilonFor(const char* key);
+
+private:
+    JsonDocument baseline;
+
+    static bool diffObject(JsonObject base, JsonObjectConst current, JsonObject changes);
+    static bool differs(JsonVariantConst before, JsonVariantConst after, float epsilon);
+};
+
+#endif // TELEMETRY_DELTA_H
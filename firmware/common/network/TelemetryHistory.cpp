@@ -0,0 +1,160 @@
+/**
+ * TelemetryHistory.cpp
+ * Telemetry sample ring implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "TelemetryHistory.h"
+#include "../utils/SeqPage.h"
+
+namespace {
+    // Names in replies, in TelemetryHistory::Field order
+    const char* const FIELD_NAMES[] = { "temperature", "setpoint", "humidity", "co2Level" };
+}
+
+const char* const TelemetryHistory::STATUS_FIELDS = "temperature,setpoint,temperatureSetpoint,humidity,co2Level";
+
+TelemetryHistory::TelemetryHistory()
+    : latest(0), count(0), present(0) {
+}
+
+uint32_t TelemetryHistory::record(const JsonDocument& status, uint32_t timestamp) {
+    // The PCR reports per-zone arrays; the first zone is charted
+    JsonVariantConst temperature = status["temperature"];
+    JsonVariantConst setpoint = status["setpoint"];
+    if (setpoint.isNull()) {
+        setpoint = status["temperatureSetpoint"];
+    }
+
+    Sample& sample = samples[latest % TELEMETRY_HISTORY_SIZE];
+    sample.timestamp = timestamp;
+    sample.values[FIELD_TEMPERATURE] = toTenths(temperature.is<JsonArrayConst>() ? temperature[0] : temperature);
+    sample.values[FIELD_SETPOINT] = toTenths(setpoint.is<JsonArrayConst>() ? setpoint[0] : setpoint);
+    sample.values[FIELD_HUMIDITY] = toTenths(status["humidity"]);
+    sample.values[FIELD_CO2] = toTenths(status["co2Level"]);
+
+    for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+        if (sample.values[field] != MISSING) {
+            present |= 1 << field;
+        }
+    }
+
+    latest++;
+    if (count < TELEMETRY_HISTORY_SIZE) {
+        count++;
+    }
+    return latest;
+}
+
+void TelemetryHistory::replay(uint32_t since, uint16_t limit, JsonDocument& out) const {
+    SeqPage page = SeqPage::after(since, limit, latest, count);
+
+    out["since"] = page.since;
+    out["next"] = page.next;
+    out["latest"] = latest;
+    out["more"] = page.next < latest;
+    out["truncated"] = page.truncated;
+    out["interval"] = TELEMETRY_SAMPLE_INTERVAL_MS / 1000.0f;
+
+    // Columns, so every row does not repeat the names
+    JsonArray fields = out["fields"].to<JsonArray>();
+    fields.add("seq");
+    fields.add("timestamp");
+    for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+        if (present & (1 << field)) {
+            fields.add(FIELD_NAMES[field]);
+        }
+    }
+
+    JsonArray rows = out["samples"].to<JsonArray>();
+    for (uint32_t seq = page.first; seq <= page.last; seq++) {
+        const Sample& sample = samples[(seq - 1) % TELEMETRY_HISTORY_SIZE];
+        JsonArray row = rows.add<JsonArray>();
+        row.add(seq);
+        row.add(sample.timestamp);
+        for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+            if (!(present & (1 << field))) continue;
+            if (sample.values[field] == MISSING) {
+                row.add(nullptr);
+            } else {
+                row.add(sample.values[field] / 10.0f);
+            }
+        }
+    }
+}
+
+uint32_t TelemetryHistory::replay(uint32_t since, uint16_t limit, String& out) const {
+    SeqPage page = SeqPage::after(since, limit, latest, count);
+    uint16_t rows = page.size();
+
+    // A row is at most ~50 characters with every field present
+    out.reserve(out.length() + 160 + rows * (24 + 7 * FIELD_COUNT));
+
+    out += "\"since\":";
+    out += page.since;
+    out += ",\"next\":";
+    out += page.next;
+    out += ",\"latest\":";
+    out += latest;
+    out += page.next < latest ? ",\"more\":true" : ",\"more\":false";
+    out += page.truncated ? ",\"truncated\":true" : ",\"truncated\":false";
+    out += ",\"interval\":";
+    appendTenths(out, TELEMETRY_SAMPLE_INTERVAL_MS / 100);
+
+    out += ",\"fields\":[\"seq\",\"timestamp\"";
+    for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+        if (present & (1 << field)) {
+            out += ",\"";
+            out += FIELD_NAMES[field];
+            out += '"';
+        }
+    }
+
+    out += "],\"samples\":[";
+    for (uint32_t seq = page.first; seq <= page.last; seq++) {
+        const Sample& sample = samples[(seq - 1) % TELEMETRY_HISTORY_SIZE];
+        if (seq != page.first) {
+            out += ',';
+        }
+        out += '[';
+        out += seq;
+        out += ',';
+        out += sample.timestamp;
+        for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+            if (!(present & (1 << field))) continue;
+            out += ',';
+            if (sample.values[field] == MISSING) {
+                out += "null";
+            } else {
+                appendTenths(out, sample.values[field]);
+            }
+        }
+        out += ']';
+    }
+    out += ']';
+    return page.next;
+}
+
+void TelemetryHistory::appendTenths(String& out, int16_t tenths) {
+    int32_t value = tenths;
+    if (value < 0) {
+        out += '-';
+        value = -value;
+    }
+    out += value / 10;
+    if (value % 10) {
+        out += '.';
+        out += (char)('0' + value % 10);
+    }
+}
+
+int16_t TelemetryHistory::toTenths(JsonVariantConst value) {
+    if (!value.is<float>()) {
+        return MISSING;
+    }
+    float tenths = value.as<float>() * 10.0f;
+    if (tenths > INT16_MAX || tenths <= INT16_MIN) {
+        return MISSING;
+    }
+    return (int16_t)(tenths < 0 ? tenths - 0.5f : tenths + 0.5f);
+}
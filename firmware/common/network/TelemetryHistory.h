@@ -0,0 +1,90 @@
+/**
+ * TelemetryHistory.h
+ * Ring of recent telemetry samples, replayed to clients that reconnect
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef TELEMETRY_HISTORY_H
+#define TELEMETRY_HISTORY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Samples kept; the oldest is overwritten when full
+#ifndef TELEMETRY_HISTORY_SIZE
+#ifdef ESP32
+#define TELEMETRY_HISTORY_SIZE 600
+#else
+#define TELEMETRY_HISTORY_SIZE 180
+#endif
+#endif
+
+// Time between samples
+#ifndef TELEMETRY_SAMPLE_INTERVAL_MS
+#define TELEMETRY_SAMPLE_INTERVAL_MS 1000
+#endif
+
+// Samples returned by one replay; a page is built in one piece, so keep it
+// small where the heap is
+#ifndef TELEMETRY_REPLAY_MAX
+#ifdef ESP32
+#define TELEMETRY_REPLAY_MAX 120
+#else
+#define TELEMETRY_REPLAY_MAX 30
+#endif
+#endif
+
+/**
+ * Keeps what a chart needs, not the whole status: a timestamp and a few
+ * readings in tenths, 12 bytes a sample. Sequence numbers are never reused,
+ * so "everything after seq N" stays a valid cursor across wrap-around
+ * (SeqPage, as in AlarmHistory). Only the WebSocket server's loop touches it, so it has no lock.
+ */
+class TelemetryHistory {
+public:
+    // Readings sampled from the status; a device has a subset
+    enum Field : uint8_t {
+        FIELD_TEMPERATURE,
+        FIELD_SETPOINT,
+        FIELD_HUMIDITY,
+        FIELD_CO2,
+        FIELD_COUNT
+    };
+
+    // Status fields to project before calling record()
+    static const char* const STATUS_FIELDS;
+
+    TelemetryHistory();
+
+    // Append a sample taken from status; returns its seq
+    uint32_t record(const JsonDocument& status, uint32_t timestamp);
+
+    uint32_t getLatestSeq() const { return latest; }
+
+    // Fill out with {"since","next","latest","more","truncated","fields","samples"}:
+    // up to limit samples after seq since, each [seq, timestamp, readings...]
+    void replay(uint32_t since, uint16_t limit, JsonDocument& out) const;
+
+    // The same members as JSON text appended to out, without the enclosing
+    // braces so the caller can add its own; no document in between. Returns
+    // "next", the seq to resume from.
+    uint32_t replay(uint32_t since, uint16_t limit, String& out) const;
+
+private:
+    struct Sample {
+        uint32_t timestamp;                 // Seconds since boot
+        int16_t values[FIELD_COUNT];        // Tenths; MISSING if the status had none
+    };
+
+    static const int16_t MISSING = INT16_MIN;
+
+    Sample samples[TELEMETRY_HISTORY_SIZE];
+    uint32_t latest;                        // Seq of the newest sample, 0 if none
+    uint16_t count;                         // Samples kept
+    uint8_t present;                        // Bit per field seen in any sample
+
+    static int16_t toTenths(JsonVariantConst value);
+    static void appendTenths(String& out, int16_t tenths);
+};
+
+#endif // TELEMETRY_HISTORY_H
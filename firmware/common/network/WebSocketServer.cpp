@@ -6,23 +6,82 @@
 
 #include "WebSocketServer.h"
 #include "../utils/Logger.h"
+#include "../utils/Hash.h"
 #include <ArduinoJson.h>
 
 // Static instance for callback
 WebSocketServer* WebSocketServer::instance = nullptr;
 
-WebSocketServer::WebSocketServer(DeviceBase& dev)
+namespace {
+    // Commands every device accepts; the device registers its own after these.
+    // get_status is answered here from the published snapshot (its type is unused).
+    const CommandRegistry::Command BUILTIN_COMMANDS[] = {
+        COMMAND("start", DeviceCommand::START, 0, CommandRegistry::PARAMS | CommandRegistry::LONG_RUNNING),
+        COMMAND("stop", DeviceCommand::STOP, 0, 0),
+        COMMAND("pause", DeviceCommand::PAUSE, 0, 0),
+        COMMAND("resume", DeviceCommand::RESUME, 0, 0),
+        COMMAND("setpoint", DeviceCommand::SETPOINT, 0, CommandRegistry::PARAMS | CommandRegistry::REQUIRES_PARAMS),
+        COMMAND("test", DeviceCommand::TEST, 0,
+                CommandRegistry::PARAMS | CommandRegistry::REQUIRES_PARAMS | CommandRegistry::LONG_RUNNING),
+        COMMAND("get_status", DeviceCommand::STOP, 0, CommandRegistry::PARAMS | CommandRegistry::LOCAL)
+    };
+
+    // Broadcasts follow the commands in the API metrics; latency is the CPU
+    // time to encode and send one, bytes the total over all its recipients
+    const char* const METRIC_BROADCASTS[] = { "telemetry", "telemetry_delta", "temperature", "alarms" };
+    const int BROADCAST_TELEMETRY = 0;
+    const int BROADCAST_TELEMETRY_DELTA = 1;
+    const int BROADCAST_TEMPERATURE = 2;
+    const int BROADCAST_ALARMS = 3;
+
+    // Subscription topic names, in WebSocketServer::Topic order
+    const char* const TOPIC_NAMES[] = { "telemetry", "temperature", "alarms", "events", "logs" };
+
+    // Status fields sent on the temperature topic; each device has a subset
+    const char* const TEMPERATURE_FIELDS =
+        "state,temperature,setpoint,temperatureSetpoint,temperatureError,temperatureStable";
+}
+
+WebSocketServer::WebSocketServer(DeviceBase& dev, ApiMetrics& am, AdmissionControl& ac)
     : device(dev),
+      metrics(am),
+      admission(ac),
+      metricsBase(ApiMetrics::NO_ENDPOINT),
       ws(nullptr),
-      lastTelemetryBroadcast(0),
-      telemetryInterval(1000),  // 1 second default
+      lastSample(0),
       port(81),
-      serverStarted(false) {
+      serverStarted(false),
+      nextCommandId(0),
+      connectedClients(0),
+      binaryClients(0),
+      deltaClients(0),
+      eventClients(0),
+      logClients(0),
+      cadenceInterval(WS_ADAPTIVE_FAST_MS),
+      cadenceTransitions(0),
+      cadenceStepAt(0),
+      cadenceActiveAt(0),
+      logHead(0),
+      logCount(0),
+      logsDropped(0) {
+
+    for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        pendingCommands[i].id = 0;
+    }
+    for (Stream& stream : streams) {
+        stream.clients = 0;
+    }
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+        clearOutbox(num);
+        reassembly[num].binary = false;
+        reassembly[num].discarding = false;
+    }
 
     instance = this;
 }
 
 WebSocketServer::~WebSocketServer() {
+    Logger::setSink(nullptr);
     if (ws) {
         delete ws;
     }
@@ -36,6 +95,25 @@ void WebSocketServer::begin(uint16_t p) {
     ws = new WebSocketsServer(port);
     ws->onEvent(staticEventHandler);
 
+    commands.add(BUILTIN_COMMANDS, sizeof(BUILTIN_COMMANDS) / sizeof(BUILTIN_COMMANDS[0]));
+    device.registerCommands(commands);
+
+    // One endpoint per command, in registry order, so a registry index is a metrics offset
+    for (uint8_t i = 0; i < commands.size(); i++) {
+        ApiMetrics::Endpoint endpoint = metrics.add("websocket", "command", commands.at(i).name);
+        if (i == 0) {
+            metricsBase = endpoint;
+        }
+    }
+    for (const char* name : METRIC_BROADCASTS) {
+        metrics.add("websocket", "broadcast", name);
+    }
+
+    fragmentPool.begin(WS_FRAGMENT_POOL_SLOTS, WS_MAX_MESSAGE_SIZE, true);
+
+    // Log lines are queued for the logs topic while anyone is subscribed
+    Logger::setSink(logSink);
+
     Logger::info("WebSocketServer: Configured, waiting for WiFi to start server");
 }
 
@@ -50,29 +128,368 @@ void WebSocketServer::loop() {
 
     if (ws && serverStarted) {
         ws->loop();
+        completeCommands();
+        flushOutboxes();
     }
 }
 
 void WebSocketServer::broadcastTelemetry() {
     if (!ws) return;
 
+    sendLogs();
+
     unsigned long now = millis();
-    if (now - lastTelemetryBroadcast < telemetryInterval) {
+    StatusSnapshot::FramePtr frame;
+
+    // Sampled whether or not anyone is connected; that is when samples are missed
+    if (now - lastSample >= TELEMETRY_SAMPLE_INTERVAL_MS) {
+        frame = device.getStatusSnapshot().get();
+        if (!frame) return;
+        lastSample = now;
+        recordSample(frame, now);
+    }
+
+    updateCadence(now);
+
+    for (Stream& stream : streams) {
+        if (!stream.clients || now - stream.lastSent < intervalOf(stream)) continue;
+
+        // One snapshot per pass, shared by every stream that is due
+        if (!frame) {
+            frame = device.getStatusSnapshot().get();
+            if (!frame) return;
+        }
+        stream.lastSent = now;
+        sendStream(stream, frame, now);
+    }
+}
+
+void WebSocketServer::updateCadence(unsigned long now) {
+    StatusSnapshot::Activity activity = device.getStatusSnapshot().getActivity();
+
+    if (activity.settling || activity.transitions != cadenceTransitions) {
+        cadenceTransitions = activity.transitions;
+        cadenceActiveAt = now;
+        cadenceStepAt = now;
+        cadenceInterval = WS_ADAPTIVE_FAST_MS;
+        return;
+    }
+
+    // Steady: after the hold, back off one doubling per interval
+    if (now - cadenceActiveAt < WS_ADAPTIVE_HOLD_MS || cadenceInterval >= WS_ADAPTIVE_FLOOR_MS ||
+        now - cadenceStepAt < cadenceInterval) {
+        return;
+    }
+    cadenceStepAt = now;
+    cadenceInterval = cadenceInterval * 2 < WS_ADAPTIVE_FLOOR_MS ? cadenceInterval * 2 : WS_ADAPTIVE_FLOOR_MS;
+}
+
+void WebSocketServer::sendStream(Stream& stream, const StatusSnapshot::FramePtr& frame, unsigned long now) {
+    if (stream.topic == TOPIC_TELEMETRY) {
+        sendTelemetry(stream, frame, now);
+        return;
+    }
+
+    uint32_t startedAt = micros();
+    String projected;
+    uint32_t hash;
+    int metric;
+
+    if (stream.topic == TOPIC_TEMPERATURE) {
+        // Nothing new since the last message; the rate is an upper bound
+        if (!stream.refresh && stream.lastHash == frame->version) return;
+        frame->project(FieldList(TEMPERATURE_FIELDS), projected);
+        hash = frame->version;
+        metric = BROADCAST_TEMPERATURE;
+    } else {
+        // Alarms go out when they change; devices without alarms never send any
+        frame->project(FieldList("alarms"), projected);
+        hash = Hash::fnv1aN(projected.c_str(), projected.length());
+        if (projected.length() <= 2 || (!stream.refresh && stream.lastHash == hash)) return;
+        metric = BROADCAST_ALARMS;
+    }
+
+    JsonDocument envelope;
+    envelope["type"] = TOPIC_NAMES[stream.topic];
+    envelope["seq"] = ++stream.seq;
+    envelope["sample"] = history.getLatestSeq();
+    envelope["timestamp"] = now / 1000;
+    envelope["version"] = frame->version;
+
+    size_t sent = sendWithStatus(stream.clients, envelope, projected, std::vector<uint8_t>(), stream.topic);
+    recordBroadcast(metric, sent, startedAt);
+    stream.lastHash = hash;
+    stream.refresh = false;
+}
+
+void WebSocketServer::sendTelemetry(Stream& stream, const StatusSnapshot::FramePtr& frame, unsigned long now) {
+    uint32_t startedAt = micros();
+    uint32_t deltaMicros = 0;
+    stream.seq++;
+
+    // Delta clients get only what moved since the state they hold, with a full
+    // keyframe every TELEMETRY_KEYFRAME_INTERVAL messages or when asked to resync
+    uint32_t fullClients = stream.clients & ~deltaClients;
+    JsonDocument delta;
+    if (stream.clients & deltaClients) {
+        JsonDocument status;
+        deserializeJson(status, frame->json);
+
+        delta["type"] = "telemetry_delta";
+        delta["seq"] = stream.seq;
+        delta["sample"] = history.getLatestSeq();
+        delta["timestamp"] = now / 1000;
+        delta["version"] = frame->version;
+        bool keyframe = stream.refresh || stream.seq - stream.keyframeSeq >= TELEMETRY_KEYFRAME_INTERVAL ||
+                        !stream.deltas.update(status, delta["data"].to<JsonObject>());
+        if (keyframe) {
+            stream.deltas.rebase(status);
+            stream.keyframeSeq = stream.seq;
+            stream.refresh = false;
+            fullClients = stream.clients;
+        }
+        deltaMicros = micros() - startedAt;
+    } else {
+        stream.deltas.reset();
+        stream.refresh = true;
+    }
+
+    // The listener is always subscribed; it only needs a message while its
+    // transport has someone to send it to
+    uint32_t recipients = fullClients;
+    if ((recipients & LISTENER_BIT) && telemetryWanted && !telemetryWanted()) {
+        recipients &= ~LISTENER_BIT;
+    }
+
+    // Create telemetry message around the published status
+    std::shared_ptr<Outbound> message;
+    if (recipients) {
+        startedAt = micros();
+        JsonDocument telemetry;
+        telemetry["type"] = "telemetry";
+        telemetry["seq"] = stream.seq;
+        telemetry["sample"] = history.getLatestSeq();
+        telemetry["timestamp"] = now / 1000;
+        telemetry["version"] = frame->version;
+
+        // Serialized once and shared by every subscriber, WebSocket and listener alike
+        message = std::make_shared<Outbound>();
+        if (recipients & ~binaryClients) {
+            message->json = withStatus(telemetry, frame->json);
+        }
+        if (recipients & binaryClients) {
+            withStatus(telemetry, frame->json, frame->msgpack, message->packed);
+        }
+
+        size_t sent = deliver(recipients, message, TOPIC_TELEMETRY);
+        if (recipients & connectedClients) {
+            recordBroadcast(BROADCAST_TELEMETRY, sent, startedAt);
+        }
+    }
+
+    if (delta.size() > 0 && fullClients != stream.clients) {
+        startedAt = micros();
+        size_t sent = send(stream.clients & ~fullClients, delta, TOPIC_TELEMETRY);
+        // Charged with the diff as well, so the two modes compare fairly
+        recordBroadcast(BROADCAST_TELEMETRY_DELTA, sent, startedAt - deltaMicros);
+    }
+
+    if ((recipients & LISTENER_BIT) && telemetryListener) {
+        telemetryListener(std::shared_ptr<const String>(message, &message->json), history.getLatestSeq());
+    }
+}
+
+void WebSocketServer::recordSample(const StatusSnapshot::FramePtr& frame, unsigned long now) {
+    // Only the charted fields are parsed
+    String projected;
+    frame->project(FieldList(TelemetryHistory::STATUS_FIELDS), projected);
+    JsonDocument status;
+    deserializeJson(status, projected);
+    history.record(status, now / 1000);
+}
+
+void WebSocketServer::handleResume(uint8_t clientNum, JsonDocument& doc) {
+    // {"since": seq} from the last "sample" the client saw; replies page by
+    // TELEMETRY_REPLAY_MAX, so the client resumes from "next" while "more" is set
+    uint32_t since = doc["since"] | 0;
+    uint16_t limit = doc["limit"] | TELEMETRY_REPLAY_MAX;
+    if (limit == 0 || limit > TELEMETRY_REPLAY_MAX) {
+        limit = TELEMETRY_REPLAY_MAX;
+    }
+
+    if (binaryClients & clientBit(clientNum)) {
+        JsonDocument replay;
+        replay["type"] = "replay";
+        history.replay(since, limit, replay);
+        sendToClient(clientNum, replay);
         return;
     }
 
-    // Get device status
-    JsonDocument status = device.getStatus();
+    std::shared_ptr<Outbound> message = std::make_shared<Outbound>();
+    writeReplay(since, limit, message->json);
+    deliver(clientBit(clientNum), message, TOPIC_NONE);
+}
 
-    // Create telemetry message
-    JsonDocument telemetry;
-    telemetry["type"] = "telemetry";
-    telemetry["timestamp"] = now / 1000;
-    telemetry["data"] = status;
+uint32_t WebSocketServer::replayTelemetry(uint32_t since, String& out) {
+    return writeReplay(since, TELEMETRY_REPLAY_MAX, out);
+}
 
-    broadcast(telemetry);
+uint32_t WebSocketServer::writeReplay(uint32_t since, uint16_t limit, String& out) {
+    // JSON rows go straight into the outgoing text, with no document in between
+    out = "{\"type\":\"replay\",";
+    uint32_t next = history.replay(since, limit, out);
+    out += '}';
+    return next;
+}
 
-    lastTelemetryBroadcast = now;
+void WebSocketServer::onTelemetry(TelemetryListener listener, std::function<bool()> wanted) {
+    telemetryListener = listener;
+    telemetryWanted = wanted;
+    if (listener) {
+        subscribe(LISTENER_BIT, TOPIC_TELEMETRY, ADAPTIVE);
+    }
+}
+
+bool WebSocketServer::subscribe(uint32_t bit, uint8_t topic, uint16_t interval) {
+    if (topic == TOPIC_EVENTS) {
+        eventClients |= bit;
+        return true;
+    }
+    if (topic == TOPIC_LOGS) {
+        logClients |= bit;
+        return true;
+    }
+
+    // Join the stream already running at this rate, or start one
+    Stream* stream = nullptr;
+    Stream* freeSlot = nullptr;
+    for (Stream& candidate : streams) {
+        if (candidate.clients && candidate.topic == topic && candidate.interval == interval) {
+            stream = &candidate;
+            break;
+        }
+        if (!candidate.clients && !freeSlot) {
+            freeSlot = &candidate;
+        }
+    }
+
+    if (!stream) {
+        if (!freeSlot) return false;
+        stream = freeSlot;
+        stream->topic = topic;
+        stream->interval = interval;
+        stream->seq = 0;
+        stream->keyframeSeq = 0;
+        stream->lastHash = 0;
+        stream->refresh = true;
+    }
+
+    stream->clients |= bit;
+    // Due on the next pass, so a new subscriber does not wait up to a whole
+    // interval (five seconds at the adaptive floor) for its first message
+    stream->lastSent = millis() - (interval == ADAPTIVE ? WS_ADAPTIVE_FLOOR_MS : interval);
+    // A new subscriber needs the whole state: a keyframe, or the current alarms
+    if (topic != TOPIC_TELEMETRY || (bit & deltaClients)) {
+        stream->refresh = true;
+    }
+    return true;
+}
+
+void WebSocketServer::unsubscribeAll(uint8_t clientNum) {
+    uint32_t bit = clientBit(clientNum);
+    for (Stream& stream : streams) {
+        if (!(stream.clients & bit)) continue;
+
+        stream.clients &= ~bit;
+        if (!stream.clients) {
+            stream.deltas.reset();
+        }
+    }
+    eventClients &= ~bit;
+    logClients &= ~bit;
+}
+
+int WebSocketServer::topicIndex(const char* name) {
+    if (!name) return -1;
+    for (int i = 0; i < TOPIC_COUNT; i++) {
+        if (strcmp(name, TOPIC_NAMES[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint16_t WebSocketServer::intervalFor(JsonVariantConst value) {
+    // No rate, "auto" or 0 follows the process
+    float rate = value.is<const char*>() ? 0.0f : value | 0.0f;
+    if (!(rate > 0.0f)) {
+        return ADAPTIVE;
+    }
+    float interval = 1000.0f / rate + 0.5f;
+    if (interval < WS_MIN_INTERVAL_MS) return WS_MIN_INTERVAL_MS;
+    if (interval > WS_MAX_INTERVAL_MS) return WS_MAX_INTERVAL_MS;
+    return (uint16_t)interval;
+}
+
+void WebSocketServer::handleSubscribe(uint8_t clientNum, JsonDocument& doc) {
+    // {"topics": {"temperature": 10, "alarms": 1}} gives each topic its own rate in Hz;
+    // {"topics": ["telemetry", "events"], "rate": 0.2} one rate for all of them.
+    // A rate of "auto" (or none) adapts to the process.
+    JsonVariant topics = doc["topics"];
+    JsonVariantConst rate = doc["rate"];
+
+    bool wanted[TOPIC_COUNT] = {};
+    uint16_t intervals[TOPIC_COUNT];
+    if (topics.is<JsonObject>()) {
+        for (JsonPair topic : topics.as<JsonObject>()) {
+            int index = topicIndex(topic.key().c_str());
+            if (index < 0) {
+                sendResponse(clientNum, false, "Unknown topic: " + String(topic.key().c_str()));
+                return;
+            }
+            wanted[index] = true;
+            intervals[index] = intervalFor(topic.value().isNull() ? rate : topic.value());
+        }
+    } else if (topics.is<JsonArray>()) {
+        for (JsonVariant topic : topics.as<JsonArray>()) {
+            int index = topicIndex(topic.as<const char*>());
+            if (index < 0) {
+                sendResponse(clientNum, false, "Unknown topic: " + topic.as<String>());
+                return;
+            }
+            wanted[index] = true;
+            intervals[index] = intervalFor(rate);
+        }
+    } else {
+        sendResponse(clientNum, false, "Missing topics");
+        return;
+    }
+
+    // The new set replaces the old one
+    unsubscribeAll(clientNum);
+
+    JsonDocument response;
+    response["type"] = "response";
+    response["success"] = true;
+    response["message"] = "Subscribed";
+    JsonObject granted = response["topics"].to<JsonObject>();
+    for (uint8_t topic = 0; topic < TOPIC_COUNT; topic++) {
+        if (!wanted[topic]) continue;
+
+        if (!subscribe(clientBit(clientNum), topic, intervals[topic])) {
+            sendResponse(clientNum, false, "Too many subscriptions");
+            return;
+        }
+        // The rate actually used, in Hz; 0 for topics sent as they happen
+        if (topic >= PERIODIC_TOPICS) {
+            granted[TOPIC_NAMES[topic]] = 0.0f;
+        } else if (intervals[topic] == ADAPTIVE) {
+            granted[TOPIC_NAMES[topic]] = "auto";
+        } else {
+            granted[TOPIC_NAMES[topic]] = 1000.0f / intervals[topic];
+        }
+    }
+    sendToClient(clientNum, response);
 }
 
 void WebSocketServer::sendEvent(const String& event, const String& message) {
@@ -84,7 +501,7 @@ void WebSocketServer::sendEvent(const String& event, const String& message) {
     doc["message"] = message;
     doc["timestamp"] = millis() / 1000;
 
-    broadcast(doc);
+    send(eventClients & connectedClients, doc, TOPIC_EVENTS);
 
     Logger::info("WebSocketServer: Event sent - " + event + ": " + message);
 }
@@ -93,56 +510,51 @@ void WebSocketServer::onWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t
     switch (type) {
         case WStype_DISCONNECTED:
             Logger::info("WebSocketServer: Client " + String(clientNum) + " disconnected");
+            connectedClients &= ~clientBit(clientNum);
+            binaryClients &= ~clientBit(clientNum);
+            deltaClients &= ~clientBit(clientNum);
+            unsubscribeAll(clientNum);
+            clearOutbox(clientNum);
+            fragmentPool.release(&reassembly[clientNum]);
+
+            // Results for this client must not reach whoever gets its slot next
+            for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+                if (pendingCommands[i].id != 0 && pendingCommands[i].clientNum == clientNum) {
+                    pendingCommands[i].id = 0;
+                }
+            }
             break;
 
         case WStype_CONNECTED: {
             IPAddress ip = ws->remoteIP(clientNum);
             Logger::info("WebSocketServer: Client " + String(clientNum) + " connected from " + ip.toString());
+            connectedClients |= clientBit(clientNum);
+            // Nothing left over from the slot's previous client
+            clearOutbox(clientNum);
+
+            // Until it subscribes to something else: telemetry at the adaptive rate, and events
+            subscribe(clientBit(clientNum), TOPIC_TELEMETRY, ADAPTIVE);
+            subscribe(clientBit(clientNum), TOPIC_EVENTS, 0);
+
+            // The payload is the request URL; /?encoding=msgpack starts the session in MessagePack
+            setEncoding(clientNum, strstr((const char*)payload, "encoding=msgpack") != nullptr);
+            // and /?telemetry=delta in delta telemetry mode
+            setTelemetryMode(clientNum, strstr((const char*)payload, "telemetry=delta") != nullptr);
 
             // Send welcome message
             JsonDocument welcome;
             welcome["type"] = "connected";
             welcome["message"] = "Connected to Axionyx device";
             welcome["clientId"] = clientNum;
+            welcome["sample"] = history.getLatestSeq();
             sendToClient(clientNum, welcome);
             break;
         }
 
-        case WStype_TEXT: {
-            Logger::debug("WebSocketServer: Received message from client " + String(clientNum));
-
-            // Parse JSON message
-            JsonDocument doc;
-            DeserializationError error = deserializeJson(doc, payload, length);
-
-            if (error) {
-                Logger::error("WebSocketServer: JSON parse error: " + String(error.c_str()));
-                sendResponse(clientNum, false, "Invalid JSON");
-                return;
-            }
-
-            // Handle different message types
-            if (!doc["type"].isNull()) {
-                String type = doc["type"];
-
-                if (type == "command") {
-                    handleCommand(clientNum, doc);
-                } else if (type == "ping") {
-                    JsonDocument pong;
-                    pong["type"] = "pong";
-                    pong["timestamp"] = millis() / 1000;
-                    sendToClient(clientNum, pong);
-                } else {
-                    sendResponse(clientNum, false, "Unknown message type");
-                }
-            } else {
-                sendResponse(clientNum, false, "Missing message type");
-            }
-            break;
-        }
-
+        case WStype_TEXT:
         case WStype_BIN:
-            Logger::warning("WebSocketServer: Binary data not supported");
+            Logger::debug("WebSocketServer: Received message from client " + String(clientNum));
+            dispatchMessage(clientNum, payload, length, type == WStype_BIN);
             break;
 
         case WStype_ERROR:
@@ -153,7 +565,7 @@ void WebSocketServer::onWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t
         case WStype_FRAGMENT_BIN_START:
         case WStype_FRAGMENT:
         case WStype_FRAGMENT_FIN:
-            Logger::warning("WebSocketServer: Fragmented messages not supported");
+            collectFragment(clientNum, type, payload, length);
             break;
 
         default:
@@ -161,73 +573,392 @@ void WebSocketServer::onWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t
     }
 }
 
+void WebSocketServer::dispatchMessage(uint8_t clientNum, uint8_t* payload, size_t length, bool msgpack) {
+    // Same per-IP and device-wide budgets as the REST API
+    uint32_t retryAfter = 0;
+    AdmissionControl::Verdict verdict = admission.admit(ws->remoteIP(clientNum), retryAfter);
+    if (verdict != AdmissionControl::ADMITTED) {
+        JsonDocument response;
+        response["type"] = "response";
+        response["success"] = false;
+        response["message"] = verdict == AdmissionControl::CLIENT_LIMITED
+                              ? "Too many requests" : "Device busy, try again";
+        response["retryAfter"] = retryAfter;
+        sendToClient(clientNum, response);
+        return;
+    }
+
+    uint32_t startedAt = micros();
+    handleMessage(clientNum, payload, length, msgpack);
+    admission.charge(micros() - startedAt);
+}
+
+void WebSocketServer::collectFragment(uint8_t clientNum, WStype_t type, uint8_t* payload, size_t length) {
+    Reassembly& message = reassembly[clientNum];
+    const void* owner = &message;
+
+    size_t collected = 0;
+    if (type == WStype_FRAGMENT_TEXT_START || type == WStype_FRAGMENT_BIN_START) {
+        // A new message; anything left from an unfinished one is dropped
+        fragmentPool.release(owner);
+        message.binary = type == WStype_FRAGMENT_BIN_START;
+        message.discarding = false;
+    } else if (message.discarding) {
+        message.discarding = type != WStype_FRAGMENT_FIN;
+        return;
+    } else if (!fragmentPool.get(owner, collected)) {
+        // Continuation without a start (or its slot was reclaimed)
+        if (type == WStype_FRAGMENT_FIN) {
+            sendResponse(clientNum, false, "Incomplete fragmented message");
+        }
+        return;
+    }
+
+    RequestBodyPool::Result result = fragmentPool.append(owner, payload, length, collected, 0);
+    if (result != RequestBodyPool::BODY_OK) {
+        fragmentPool.release(owner);
+        message.discarding = type != WStype_FRAGMENT_FIN;
+        sendResponse(clientNum, false, result == RequestBodyPool::BODY_TOO_LARGE
+                     ? "Message too large (max " + String(fragmentPool.capacity()) + " bytes)"
+                     : String("Device busy, try again"));
+        return;
+    }
+
+    if (type != WStype_FRAGMENT_FIN) {
+        return;
+    }
+
+    // Parsed straight from the slot; the slot stays claimed until the handler returns
+    size_t len = 0;
+    char* data = fragmentPool.get(owner, len);
+    Logger::debug("WebSocketServer: Reassembled " + String(len) + " byte message from client " + String(clientNum));
+    dispatchMessage(clientNum, (uint8_t*)data, len, message.binary);
+    fragmentPool.release(owner);
+}
+
+void WebSocketServer::setEncoding(uint8_t clientNum, bool msgpack) {
+    // Anything queued was serialized for the old encoding only
+    if (((binaryClients & clientBit(clientNum)) != 0) != msgpack) {
+        clearOutbox(clientNum);
+    }
+
+    if (msgpack) {
+        binaryClients |= clientBit(clientNum);
+        // Telemetry reuses the MessagePack status the control loop encodes
+        device.getStatusSnapshot().wantMsgPack();
+    } else {
+        binaryClients &= ~clientBit(clientNum);
+    }
+}
+
+void WebSocketServer::setTelemetryMode(uint8_t clientNum, bool delta) {
+    if (delta) {
+        // It has to start from a keyframe
+        deltaClients |= clientBit(clientNum);
+        requestKeyframe(clientNum);
+    } else {
+        deltaClients &= ~clientBit(clientNum);
+    }
+}
+
+void WebSocketServer::requestKeyframe(uint8_t clientNum) {
+    for (Stream& stream : streams) {
+        if (stream.topic == TOPIC_TELEMETRY && (stream.clients & clientBit(clientNum))) {
+            stream.refresh = true;
+        }
+    }
+}
+
+void WebSocketServer::handleMessage(uint8_t clientNum, uint8_t* payload, size_t length, bool msgpack) {
+    // Binary frames carry MessagePack; a client that sends one gets MessagePack back
+    JsonDocument doc;
+    DeserializationError error;
+    if (msgpack) {
+        setEncoding(clientNum, true);
+        error = deserializeMsgPack(doc, payload, length);
+    } else {
+        error = deserializeJson(doc, payload, length);
+    }
+
+    if (error) {
+        Logger::error("WebSocketServer: Parse error: " + String(error.c_str()));
+        sendResponse(clientNum, false, msgpack ? "Invalid MessagePack" : "Invalid JSON");
+        return;
+    }
+
+    const char* type = doc["type"];
+    if (!type) {
+        sendResponse(clientNum, false, "Missing message type");
+        return;
+    }
+
+    // The case labels are hashed at compile time (two types sharing a hash
+    // would not compile); the strcmp turns away an unknown type that collides
+    switch (Hash::fnv1aN(type, strlen(type))) {
+        case Hash::fnv1a("command"):
+            if (strcmp(type, "command") != 0) break;
+            handleCommand(clientNum, doc);
+            return;
+
+        case Hash::fnv1a("ping"): {
+            if (strcmp(type, "ping") != 0) break;
+            JsonDocument pong;
+            pong["type"] = "pong";
+            pong["timestamp"] = millis() / 1000;
+            sendToClient(clientNum, pong);
+            return;
+        }
+
+        case Hash::fnv1a("telemetry_mode"): {
+            if (strcmp(type, "telemetry_mode") != 0) break;
+            String mode = doc["mode"] | "";
+            if (mode == "delta" || mode == "full") {
+                setTelemetryMode(clientNum, mode == "delta");
+                sendResponse(clientNum, true, "Telemetry mode set to " + mode);
+            } else {
+                sendResponse(clientNum, false, "Unknown telemetry mode");
+            }
+            return;
+        }
+
+        case Hash::fnv1a("resume"):
+            if (strcmp(type, "resume") != 0) break;
+            handleResume(clientNum, doc);
+            return;
+
+        case Hash::fnv1a("subscribe"):
+            if (strcmp(type, "subscribe") != 0) break;
+            handleSubscribe(clientNum, doc);
+            return;
+
+        case Hash::fnv1a("resync"):
+            if (strcmp(type, "resync") != 0) break;
+            // The client saw a gap in the delta sequence; everyone on its stream gets a keyframe next
+            requestKeyframe(clientNum);
+            sendResponse(clientNum, true, "Keyframe on next telemetry");
+            return;
+
+        case Hash::fnv1a("encoding"): {
+            if (strcmp(type, "encoding") != 0) break;
+            String format = doc["format"] | "";
+            if (format == "msgpack" || format == "json") {
+                setEncoding(clientNum, format == "msgpack");
+                sendResponse(clientNum, true, "Encoding set to " + format);
+            } else {
+                sendResponse(clientNum, false, "Unknown encoding");
+            }
+            return;
+        }
+    }
+
+    sendResponse(clientNum, false, "Unknown message type");
+}
+
 void WebSocketServer::handleCommand(uint8_t clientNum, JsonDocument& doc) {
-    if (doc["command"].isNull()) {
+    uint32_t receivedAt = micros();
+    const char* name = doc["command"];
+    if (!name) {
         sendResponse(clientNum, false, "Missing command field");
         return;
     }
 
-    String command = doc["command"];
     String requestId = doc["requestId"] | "";
+    uint8_t index = commands.find(name, strlen(name));
+    if (index == CommandRegistry::NOT_FOUND) {
+        replyCommand(clientNum, requestId, false, "Unknown command: " + String(name), -1, receivedAt);
+        return;
+    }
 
-    Logger::info("WebSocketServer: Command received - " + command);
+    const CommandRegistry::Command& entry = commands.at(index);
+    Logger::info("WebSocketServer: Command received - " + String(entry.name));
 
-    bool success = false;
-    String message = "";
+    JsonVariantConst params = doc["params"];
+    if ((entry.flags & CommandRegistry::REQUIRES_PARAMS) && params.isNull()) {
+        replyCommand(clientNum, requestId, false, "Missing parameters", index, receivedAt);
+        return;
+    }
 
-    if (command == "start") {
-        JsonDocument params = doc["params"];
-        success = device.start(params);
-        message = success ? "Device started" : "Failed to start device";
+    if (entry.flags & CommandRegistry::LOCAL) {
+        switch (entry.key) {
+            case Hash::fnv1a("get_status"):
+                handleGetStatus(clientNum, params, requestId, index, receivedAt);
+                return;
+        }
+        replyCommand(clientNum, requestId, false, "Command not available", index, receivedAt);
+        return;
+    }
 
-    } else if (command == "stop") {
-        success = device.stop();
-        message = success ? "Device stopped" : "Failed to stop device";
+    // Control commands run on the next control tick; the result is sent
+    // from completeCommands() once the device has applied them
+    DeviceCommand command;
+    command.type = entry.type;
+    command.code = entry.code;
 
-    } else if (command == "pause") {
-        success = device.pause();
-        message = success ? "Device paused" : "Failed to pause device";
+    if (entry.type == DeviceCommand::SETPOINT) {
+        command.zone = params["zone"] | 0;
+        command.value = params["temperature"] | 0.0f;
+    } else if (entry.type == DeviceCommand::ACK_ALARM) {
+        if (!params["index"].is<uint8_t>()) {
+            replyCommand(clientNum, requestId, false, "Missing or invalid 'index' parameter", index, receivedAt);
+            return;
+        }
+        command.zone = params["index"];
+    }
 
-    } else if (command == "resume") {
-        success = device.resume();
-        message = success ? "Device resumed" : "Failed to resume device";
+    const char* invalid = device.checkParams(entry.type, entry.code, command.zone, command.value, params);
+    if (invalid) {
+        replyCommand(clientNum, requestId, false, invalid, index, receivedAt);
+        return;
+    }
 
-    } else if (command == "setpoint") {
-        if (!doc["params"].isNull()) {
-            JsonObject params = doc["params"];
-            uint8_t zone = params["zone"] | 0;
-            float temperature = params["temperature"] | 0.0;
+    // Any queued command can ask for an early "accepted", so clients can pipeline
+    bool async = (entry.flags & CommandRegistry::LONG_RUNNING) || (doc["async"] | false);
 
-            success = device.setSetpoint(zone, temperature);
-            message = success ? "Setpoint updated" : "Failed to update setpoint";
-        } else {
-            message = "Missing parameters";
-        }
-
-    } else if (command == "get_status") {
-        JsonDocument status = device.getStatus();
+    if (entry.flags & CommandRegistry::PARAMS) {
+        // Hand the whole message over instead of copying "params" out of it
+        command.params = std::move(doc);
+        command.wrapped = true;
+    }
 
-        JsonDocument response;
-        response["type"] = "response";
-        response["success"] = true;
-        response["requestId"] = requestId;
-        response["data"] = status;
+    submitCommand(clientNum, requestId, index, async, command, receivedAt);
+}
 
-        sendToClient(clientNum, response);
+void WebSocketServer::handleGetStatus(uint8_t clientNum, JsonVariantConst params, const String& requestId,
+                                      uint8_t command, uint32_t receivedAt) {
+    StatusSnapshot::FramePtr frame = device.getStatusSnapshot().get();
+    if (!frame) {
+        replyCommand(clientNum, requestId, false, "Status not available yet", command, receivedAt);
         return;
+    }
+
+    JsonDocument response;
+    response["type"] = "response";
+    response["success"] = true;
+    response["requestId"] = requestId;
+    response["version"] = frame->version;
 
+    // Optional "fields": "a,b" or ["a", "b"] selects top-level status fields
+    size_t sent;
+    JsonVariantConst fields = params["fields"];
+    if (fields.isNull()) {
+        sent = sendWithStatus(clientBit(clientNum), response, frame->json, frame->msgpack);
     } else {
-        message = "Unknown command: " + command;
+        String list;
+        if (fields.is<JsonArrayConst>()) {
+            for (JsonVariantConst field : fields.as<JsonArrayConst>()) {
+                list += field.as<const char*>();
+                list += ',';
+            }
+        } else {
+            list = fields.as<String>();
+        }
+        String projected;
+        frame->project(FieldList(list.c_str()), projected);
+        sent = sendWithStatus(clientBit(clientNum), response, projected, std::vector<uint8_t>());
     }
+    recordCommand(command, true, sent, receivedAt);
+}
 
-    // Send command response
+void WebSocketServer::replyCommand(uint8_t clientNum, const String& requestId, bool success,
+                                   const String& message, int metric, uint32_t receivedAt) {
     JsonDocument response;
     response["type"] = "response";
     response["success"] = success;
     response["message"] = message;
     response["requestId"] = requestId;
 
-    sendToClient(clientNum, response);
+    size_t sent = sendToClient(clientNum, response);
+    recordCommand(metric, success, sent, receivedAt);
+}
+
+namespace {
+    // Result messages for each DeviceCommand::Type, indexed by type
+    const char* const COMMAND_MESSAGES[][2] = {
+        { "Device started",          "Failed to start device" },
+        { "Device stopped",          "Failed to stop device" },
+        { "Device paused",           "Failed to pause device" },
+        { "Device resumed",          "Failed to resume device" },
+        { "Setpoint updated",        "Failed to update setpoint" },
+        { "Test executed",           "Test command not supported" },
+        { "Batch executed",          "Batch operation failed" },
+        { "Alarm acknowledged",      "No active alarm at that index" },
+        { "All alarms acknowledged", "Failed to acknowledge alarms" },
+        { "Command completed",       "Command failed" }
+    };
+}
+
+void WebSocketServer::submitCommand(uint8_t clientNum, const String& requestId, uint8_t index, bool async,
+                                    DeviceCommand& command, uint32_t receivedAt) {
+    PendingCommand* slot = nullptr;
+    for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+        if (pendingCommands[i].id == 0) {
+            slot = &pendingCommands[i];
+            break;
+        }
+    }
+
+    if (slot) {
+        if (++nextCommandId == 0) nextCommandId = 1;
+        command.id = nextCommandId;
+        DeviceCommand::Type type = command.type;
+
+        if (device.getCommandQueue().submit(CommandQueue::LANE_WEBSOCKET, command)) {
+            slot->id = command.id;
+            slot->clientNum = clientNum;
+            slot->command = index;
+            slot->type = type;
+            slot->async = async;
+            slot->requestId = requestId;
+            slot->receivedAt = receivedAt;
+            slot->bytesOut = 0;
+
+            if (async) {
+                JsonDocument accepted;
+                accepted["type"] = "response";
+                accepted["success"] = true;
+                accepted["status"] = "accepted";
+                accepted["command"] = commands.at(index).name;
+                accepted["requestId"] = requestId;
+                slot->bytesOut = sendToClient(clientNum, accepted);
+            }
+            return;
+        }
+    }
+
+    replyCommand(clientNum, requestId, false, "Device busy, try again", index, receivedAt);
+}
+
+void WebSocketServer::recordCommand(int metric, bool success, size_t bytesOut, uint32_t receivedAt) {
+    if (metric < 0) {
+        return;
+    }
+    metrics.record(ApiMetrics::offset(metricsBase, metric), !success, bytesOut, micros() - receivedAt);
+}
+
+void WebSocketServer::completeCommands() {
+    CommandResult result;
+    while (device.getCommandQueue().takeResult(CommandQueue::LANE_WEBSOCKET, result)) {
+        for (uint8_t i = 0; i < COMMAND_QUEUE_DEPTH; i++) {
+            PendingCommand& slot = pendingCommands[i];
+            if (slot.id != result.id) continue;
+
+            // An accepted command finishes with a completion event; the rest
+            // get their one response now. Latency and bytes cover both messages.
+            JsonDocument response;
+            response["type"] = slot.async ? "completion" : "response";
+            if (slot.async) {
+                response["command"] = commands.at(slot.command).name;
+            }
+            response["success"] = result.success;
+            response["message"] = COMMAND_MESSAGES[slot.type][result.success ? 0 : 1];
+            response["requestId"] = slot.requestId;
+            size_t sent = slot.bytesOut + sendToClient(slot.clientNum, response);
+            recordCommand(slot.command, result.success, sent, slot.receivedAt);
+
+            slot.id = 0;
+            break;
+        }
+    }
 }
 
 void WebSocketServer::sendResponse(uint8_t clientNum, bool success, const String& message) {
@@ -239,20 +970,289 @@ void WebSocketServer::sendResponse(uint8_t clientNum, bool success, const String
     sendToClient(clientNum, doc);
 }
 
-void WebSocketServer::sendToClient(uint8_t clientNum, const JsonDocument& doc) {
-    if (!ws) return;
+size_t WebSocketServer::sendToClient(uint8_t clientNum, const JsonDocument& doc) {
+    if (!ws) return 0;
 
-    String json;
-    serializeJson(doc, json);
-    ws->sendTXT(clientNum, json);
+    return send(clientBit(clientNum), doc);
 }
 
-void WebSocketServer::broadcast(const JsonDocument& doc) {
-    if (!ws) return;
+size_t WebSocketServer::send(uint32_t clients, const JsonDocument& doc, uint8_t topic) {
+    std::shared_ptr<Outbound> message = std::make_shared<Outbound>();
+    if (clients & ~binaryClients) {
+        serializeJson(doc, message->json);
+    }
+    if (clients & binaryClients) {
+        message->packed.resize(measureMsgPack(doc));
+        serializeMsgPack(doc, message->packed.data(), message->packed.size());
+    }
+    return deliver(clients, message, topic);
+}
+
+size_t WebSocketServer::sendWithStatus(uint32_t clients, const JsonDocument& envelope, const String& status,
+                                       const std::vector<uint8_t>& packedStatus, uint8_t topic) {
+    std::shared_ptr<Outbound> message = std::make_shared<Outbound>();
+    if (clients & ~binaryClients) {
+        message->json = withStatus(envelope, status);
+    }
+    if (clients & binaryClients) {
+        withStatus(envelope, status, packedStatus, message->packed);
+    }
+    return deliver(clients, message, topic);
+}
+
+size_t WebSocketServer::deliver(uint32_t clients, const OutboundPtr& message, uint8_t topic) {
+    size_t sent = 0;
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+        if (!(clients & clientBit(num))) continue;
+
+        // Nothing more for a client that is being dropped; written straight
+        // away unless the client is already behind
+        const Outbox& box = outboxes[num];
+        if (box.dropReason) {
+            continue;
+        }
+        if (box.congested || box.count > 0) {
+            enqueue(num, message, topic);
+        } else {
+            write(num, *message);
+        }
+        sent += sizeFor(num, *message);
+    }
+    return sent;
+}
+
+// ============================================================================
+// Backpressure
+// ============================================================================
+
+bool WebSocketServer::write(uint8_t clientNum, const Outbound& message) {
+    uint32_t startedAt = micros();
+    bool written;
+    if (binaryClients & clientBit(clientNum)) {
+        written = ws->sendBIN(clientNum, message.packed.data(), message.packed.size());
+    } else {
+        written = ws->sendTXT(clientNum, message.json.c_str(), message.json.length());
+    }
+
+    // A failed write lost the message, and with it the order the client relies
+    // on; the client is dropped and resyncs on reconnect ("resume"). If the
+    // library already found it gone, it disconnected it inside the send and
+    // the slot has been cleared for the next client: leave that alone.
+    Outbox& box = outboxes[clientNum];
+    if (!written) {
+        if ((connectedClients & clientBit(clientNum)) && !box.dropReason) {
+            box.dropReason = "send_failed";
+        }
+        return false;
+    }
+
+    // A slow write means the send buffer was full and TCP had to wait for the client
+    if (micros() - startedAt <= WS_SLOW_WRITE_US) {
+        return true;
+    }
+
+    unsigned long now = millis();
+    if (!box.congested) {
+        box.congested = true;
+        box.congestedSince = now;
+        Logger::warning("WebSocketServer: Client " + String(clientNum) + " is congested");
+    }
+    box.retryAt = now + WS_CONGESTED_RETRY_MS;
+    return false;
+}
+
+void WebSocketServer::enqueue(uint8_t clientNum, const OutboundPtr& message, uint8_t topic) {
+    Outbox& box = outboxes[clientNum];
+
+    if (topic < PERIODIC_TOPICS) {
+        // Only the latest matters; a delta client that misses one needs a keyframe
+        OutboundPtr& slot = box.latest[topic];
+        if (slot) {
+            box.bytes -= sizeFor(clientNum, *slot);
+            if (topic == TOPIC_TELEMETRY && (deltaClients & clientBit(clientNum))) {
+                requestKeyframe(clientNum);
+            }
+        }
+        slot = message;
+    } else if (box.count < WS_CLIENT_QUEUE_DEPTH) {
+        box.ordered[(box.head + box.count) % WS_CLIENT_QUEUE_DEPTH] = message;
+        box.count++;
+    } else if (topic == TOPIC_LOGS) {
+        // Log lines are best effort; not worth losing the client over
+        return;
+    } else {
+        // Responses and events cannot be skipped, so the client has to go
+        box.dropReason = "overflow";
+        return;
+    }
+
+    box.bytes += sizeFor(clientNum, *message);
+    reportQueue(clientNum);
+}
+
+void WebSocketServer::flushOutboxes() {
+    unsigned long now = millis();
+
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+        if (!(connectedClients & clientBit(num))) continue;
 
+        Outbox& box = outboxes[num];
+        if (box.congested && !box.dropReason && now - box.congestedSince >= WS_STALL_TIMEOUT_MS) {
+            box.dropReason = "stalled";
+        }
+        if (box.dropReason) {
+            const char* reason = box.dropReason;
+            Logger::warning("WebSocketServer: Dropping client " + String(num) + " (" + reason + ")");
+            metrics.countClientDrop(reason);
+            clearOutbox(num);
+            ws->disconnect(num);
+            continue;
+        }
+        if (!box.congested || (long)(now - box.retryAt) < 0) continue;
+
+        // Responses and events in order, then the latest of each periodic topic.
+        // Stop at the first slow write and try again after WS_CONGESTED_RETRY_MS.
+        bool keepingUp = true;
+        while (keepingUp && box.count > 0) {
+            OutboundPtr message = box.ordered[box.head];
+            box.ordered[box.head].reset();
+            box.head = (box.head + 1) % WS_CLIENT_QUEUE_DEPTH;
+            box.count--;
+            box.bytes -= sizeFor(num, *message);
+            keepingUp = write(num, *message);
+        }
+        for (uint8_t topic = 0; keepingUp && topic < PERIODIC_TOPICS; topic++) {
+            if (!box.latest[topic]) continue;
+            OutboundPtr message = box.latest[topic];
+            box.latest[topic].reset();
+            box.bytes -= sizeFor(num, *message);
+            keepingUp = write(num, *message);
+        }
+
+        if (keepingUp) {
+            box.congested = false;
+            Logger::info("WebSocketServer: Client " + String(num) + " caught up");
+        }
+        reportQueue(num);
+    }
+}
+
+void WebSocketServer::clearOutbox(uint8_t clientNum) {
+    Outbox& box = outboxes[clientNum];
+    for (OutboundPtr& message : box.latest) {
+        message.reset();
+    }
+    for (OutboundPtr& message : box.ordered) {
+        message.reset();
+    }
+    box.head = 0;
+    box.count = 0;
+    box.bytes = 0;
+    box.congested = false;
+    box.congestedSince = 0;
+    box.retryAt = 0;
+    box.dropReason = nullptr;
+    reportQueue(clientNum);
+}
+
+void WebSocketServer::reportQueue(uint8_t clientNum) {
+    const Outbox& box = outboxes[clientNum];
+    uint16_t depth = box.count;
+    for (const OutboundPtr& message : box.latest) {
+        if (message) depth++;
+    }
+    metrics.setClientQueue(clientNum, (connectedClients & clientBit(clientNum)) != 0, depth, box.bytes);
+}
+
+size_t WebSocketServer::sizeFor(uint8_t clientNum, const Outbound& message) const {
+    return (binaryClients & clientBit(clientNum)) ? message.packed.size() : message.json.length();
+}
+
+String WebSocketServer::withStatus(const JsonDocument& envelope, const String& status) {
     String json;
-    serializeJson(doc, json);
-    ws->broadcastTXT(json);
+    json.reserve(measureJson(envelope) + status.length() + 10);
+    serializeJson(envelope, json);
+
+    // Splice the already-serialized status in as "data" before the closing brace
+    json.remove(json.length() - 1);
+    json += ",\"data\":";
+    json += status;
+    json += '}';
+    return json;
+}
+
+void WebSocketServer::withStatus(const JsonDocument& envelope, const String& status,
+                                 const std::vector<uint8_t>& packedStatus, std::vector<uint8_t>& out) {
+    // Until the control loop has encoded a MessagePack frame (or for a projection) convert here
+    std::vector<uint8_t> converted;
+    if (packedStatus.empty()) {
+        JsonDocument doc;
+        deserializeJson(doc, status);
+        converted.resize(measureMsgPack(doc));
+        serializeMsgPack(doc, converted.data(), converted.size());
+    }
+    const std::vector<uint8_t>& data = packedStatus.empty() ? converted : packedStatus;
+
+    size_t length = measureMsgPack(envelope);
+    out.resize(length + 5 + data.size());
+    serializeMsgPack(envelope, out.data(), length);
+
+    // Envelopes are small fixmaps (0x80 | member count), so adding "data" is count + 1
+    out[0]++;
+    memcpy(&out[length], "\xa4" "data", 5);
+    memcpy(&out[length + 5], data.data(), data.size());
+}
+
+void WebSocketServer::logSink(const char* level, const String& message) {
+    if (instance) {
+        instance->queueLog(level, message);
+    }
+}
+
+void WebSocketServer::queueLog(const char* level, const String& message) {
+    // Nobody listening: don't pay for the copy
+    if (!logClients) return;
+
+    unsigned long now = millis();
+    CriticalSection lock(logMux);
+    if (logCount == WS_LOG_QUEUE_DEPTH) {
+        logsDropped++;
+        return;
+    }
+    LogLine& line = logQueue[(logHead + logCount) % WS_LOG_QUEUE_DEPTH];
+    line.timestamp = now;
+    line.level = level;
+    strncpy(line.message, message.c_str(), sizeof(line.message) - 1);
+    line.message[sizeof(line.message) - 1] = '\0';
+    logCount++;
+}
+
+void WebSocketServer::sendLogs() {
+    for (;;) {
+        LogLine line;
+        uint32_t dropped;
+        {
+            CriticalSection lock(logMux);
+            if (logCount == 0) return;
+            line = logQueue[logHead];
+            logHead = (logHead + 1) % WS_LOG_QUEUE_DEPTH;
+            logCount--;
+            dropped = logsDropped;
+            logsDropped = 0;
+        }
+
+        if (!(logClients & connectedClients)) continue;
+
+        JsonDocument doc;
+        doc["type"] = "log";
+        doc["level"] = line.level;
+        doc["message"] = line.message;
+        doc["timestamp"] = line.timestamp / 1000;
+        if (dropped > 0) {
+            doc["dropped"] = dropped;     // Lines lost to a full queue since the last one sent
+        }
+        send(logClients & connectedClients, doc, TOPIC_LOGS);
+    }
 }
 
 void WebSocketServer::staticEventHandler(uint8_t clientNum, WStype_t type, uint8_t* payload, size_t length) {
@@ -9,36 +9,311 @@
 
 #include <Arduino.h>
 #include <WebSocketsServer.h>
+#include <vector>
+#include <memory>
+#include <functional>
 #include "../device/DeviceBase.h"
+#include "ApiMetrics.h"
+#include "AdmissionControl.h"
+#include "TelemetryDelta.h"
+#include "TelemetryHistory.h"
+#include "RequestBodyPool.h"
+#include "../utils/CriticalSection.h"
+
+// Adaptive ("auto") rate, used by new clients and the telemetry listener:
+// the fast interval while the process is moving, the floor it decays to once
+// values hold steady, and how long a transition keeps it fast
+#ifndef WS_ADAPTIVE_FAST_MS
+#define WS_ADAPTIVE_FAST_MS 100
+#endif
+#ifndef WS_ADAPTIVE_FLOOR_MS
+#define WS_ADAPTIVE_FLOOR_MS 5000
+#endif
+#ifndef WS_ADAPTIVE_HOLD_MS
+#define WS_ADAPTIVE_HOLD_MS 3000
+#endif
+
+// Fastest and slowest rates a client can subscribe at, as message intervals
+#ifndef WS_MIN_INTERVAL_MS
+#define WS_MIN_INTERVAL_MS 100
+#endif
+#ifndef WS_MAX_INTERVAL_MS
+#define WS_MAX_INTERVAL_MS 60000
+#endif
+
+// Log lines held for the logs topic between loop passes, and their length
+#ifndef WS_LOG_QUEUE_DEPTH
+#define WS_LOG_QUEUE_DEPTH 8
+#endif
+#ifndef WS_LOG_LINE_MAX
+#define WS_LOG_LINE_MAX 96
+#endif
+
+// Fragmented messages reassembled at once, and the largest accepted. Clients
+// rarely fragment, so the buffers are only allocated while a message is open.
+#ifndef WS_FRAGMENT_POOL_SLOTS
+#define WS_FRAGMENT_POOL_SLOTS 2
+#endif
+#ifndef WS_MAX_MESSAGE_SIZE
+#define WS_MAX_MESSAGE_SIZE 2048
+#endif
+
+// Responses and events held for a client that is not keeping up; one more drops it
+#ifndef WS_CLIENT_QUEUE_DEPTH
+#define WS_CLIENT_QUEUE_DEPTH 8
+#endif
+
+// A write that takes longer than this found the client's send buffer full
+#ifndef WS_SLOW_WRITE_US
+#define WS_SLOW_WRITE_US 20000
+#endif
+
+// How often a congested client is written to, and how long it may stay congested
+#ifndef WS_CONGESTED_RETRY_MS
+#define WS_CONGESTED_RETRY_MS 500
+#endif
+#ifndef WS_STALL_TIMEOUT_MS
+#define WS_STALL_TIMEOUT_MS 10000
+#endif
 
 class WebSocketServer {
 public:
-    WebSocketServer(DeviceBase& device);
+    WebSocketServer(DeviceBase& device, ApiMetrics& metrics, AdmissionControl& admission);
     ~WebSocketServer();
 
     void begin(uint16_t port);
     void loop();
 
-    // Broadcast methods
+    // Send telemetry, temperature and alarm messages to the subscriptions that
+    // are due, and queued log lines; call on every loop pass
     void broadcastTelemetry();
+    // Push an event to clients subscribed to events
     void sendEvent(const String& event, const String& message);
 
+    // Also hand every telemetry message, as JSON, to another transport, with
+    // the seq of the newest sample as its id. While wanted returns false
+    // (nobody on that transport) no message is built for it.
+    typedef std::function<void(const std::shared_ptr<const String>& message, uint32_t id)> TelemetryListener;
+    void onTelemetry(TelemetryListener listener, std::function<bool()> wanted = nullptr);
+
+    // The JSON "replay" message a client resuming after sample since gets,
+    // for another transport; returns the seq to resume from next. Call from
+    // the same task as broadcastTelemetry().
+    uint32_t replayTelemetry(uint32_t since, String& out);
+
 private:
     DeviceBase& device;
+    ApiMetrics& metrics;
+    AdmissionControl& admission;
+    ApiMetrics::Endpoint metricsBase;   // Metrics endpoint of the first command
+    CommandRegistry commands;           // Built-ins, then the device's own
     WebSocketsServer* ws;
-    unsigned long lastTelemetryBroadcast;
-    uint16_t telemetryInterval;
+    TelemetryListener telemetryListener;
+    std::function<bool()> telemetryWanted;
+
+    // Recent samples for clients resuming after a disconnect
+    TelemetryHistory history;
+    unsigned long lastSample;
+    void recordSample(const StatusSnapshot::FramePtr& frame, unsigned long now);
+    void handleResume(uint8_t clientNum, JsonDocument& doc);
+    uint32_t writeReplay(uint32_t since, uint16_t limit, String& out);
+
     uint16_t port;
     bool serverStarted;
 
+    // A device command waiting for its result from the control loop
+    struct PendingCommand {
+        uint32_t id;                // 0 when the slot is free
+        uint8_t clientNum;
+        uint8_t command;            // Registry index
+        DeviceCommand::Type type;
+        bool async;                 // Already answered "accepted"; the result goes out as a completion
+        String requestId;           // Echoed back to the client
+        uint32_t receivedAt;        // micros(), for the latency metrics
+        size_t bytesOut;            // Sent so far (the "accepted" reply)
+    };
+
+    PendingCommand pendingCommands[COMMAND_QUEUE_DEPTH];
+    uint32_t nextCommandId;
+
+    // Bit per client number: connected, and talking MessagePack (binary frames) instead of JSON
+    uint32_t connectedClients;
+    uint32_t binaryClients;
+    uint32_t deltaClients;              // Delta telemetry instead of the full status
+    uint32_t eventClients;              // Subscribed to events
+    uint32_t logClients;                // Subscribed to logs
+
+    static uint32_t clientBit(uint8_t clientNum) {
+        return 1UL << clientNum;
+    }
+    void setEncoding(uint8_t clientNum, bool msgpack);
+    void setTelemetryMode(uint8_t clientNum, bool delta);
+    void requestKeyframe(uint8_t clientNum);
+
+    // Subscription topics. The periodic ones come first and are sent at the
+    // rate each client asked for; events and logs go out as they happen.
+    enum Topic : uint8_t {
+        TOPIC_TELEMETRY,
+        TOPIC_TEMPERATURE,
+        TOPIC_ALARMS,
+        TOPIC_EVENTS,
+        TOPIC_LOGS,
+        TOPIC_COUNT,
+        TOPIC_NONE = TOPIC_COUNT        // Responses and other direct messages
+    };
+    static const uint8_t PERIODIC_TOPICS = TOPIC_EVENTS;
+
+    /**
+     * One (topic, interval) schedule, shared by every client subscribed to the
+     * topic at that rate: its message is serialized once per tick (once per
+     * encoding) however many clients are on it. Clients at different rates are
+     * on different streams, so each delta telemetry stream keeps its own
+     * baseline and sequence.
+     */
+    struct Stream {
+        uint32_t clients;           // Subscribers; 0 when the slot is free
+        uint8_t topic;
+        uint16_t interval;          // ms between messages, or ADAPTIVE
+        unsigned long lastSent;
+        uint32_t seq;               // Messages sent on this stream
+        uint32_t keyframeSeq;       // Telemetry: seq of the last keyframe
+        bool refresh;               // Next message is a keyframe, or sent even if unchanged
+        uint32_t lastHash;          // Alarms: hash of the last message sent
+        TelemetryDelta deltas;      // Telemetry: baseline of its delta clients
+    };
+
+    // Stream interval that follows the process: see updateCadence()
+    static const uint16_t ADAPTIVE = 0;
+
+    // Every client on every periodic topic at a different rate, plus the listener, still fits
+    static const uint8_t STREAM_MAX = PERIODIC_TOPICS * WEBSOCKETS_SERVER_CLIENT_MAX + 1;
+    Stream streams[STREAM_MAX];
+
+    // The telemetry listener rides the default telemetry stream as a pseudo-client
+    // that deliver() never sends to
+    static const uint32_t LISTENER_BIT = 1UL << WEBSOCKETS_SERVER_CLIENT_MAX;
+
+    /**
+     * Interval of the ADAPTIVE streams. Any state, phase or stage change or
+     * alarm transition, or the device reporting it is still settling, drops
+     * it to WS_ADAPTIVE_FAST_MS. Once nothing has moved for
+     * WS_ADAPTIVE_HOLD_MS it doubles each time it elapses, up to the floor.
+     */
+    uint16_t cadenceInterval;
+    uint32_t cadenceTransitions;        // Activity count last seen
+    unsigned long cadenceStepAt;        // Last change of cadenceInterval, or last activity
+    unsigned long cadenceActiveAt;      // Last time the process was moving
+    void updateCadence(unsigned long now);
+    uint16_t intervalOf(const Stream& stream) const {
+        return stream.interval == ADAPTIVE ? cadenceInterval : stream.interval;
+    }
+
+    bool subscribe(uint32_t bit, uint8_t topic, uint16_t interval);
+    void unsubscribeAll(uint8_t clientNum);
+    void handleSubscribe(uint8_t clientNum, JsonDocument& doc);
+    void sendStream(Stream& stream, const StatusSnapshot::FramePtr& frame, unsigned long now);
+    void sendTelemetry(Stream& stream, const StatusSnapshot::FramePtr& frame, unsigned long now);
+    static int topicIndex(const char* name);
+    static uint16_t intervalFor(JsonVariantConst rate);
+
+    // One serialized message, shared by every client it is sent or queued to
+    struct Outbound {
+        String json;
+        std::vector<uint8_t> packed;
+    };
+    typedef std::shared_ptr<const Outbound> OutboundPtr;
+
+    /**
+     * What is waiting for one client. Writes are synchronous, so a client with
+     * a full send buffer holds up loop() and everyone behind it. A slow write
+     * marks the client congested: from then on its messages queue here and it
+     * is written to at most every WS_CONGESTED_RETRY_MS. Periodic topics keep
+     * only their latest message; responses, events and logs stay in order.
+     * A write that fails outright drops the client, as a gap would.
+     */
+    struct Outbox {
+        OutboundPtr latest[PERIODIC_TOPICS];
+        OutboundPtr ordered[WS_CLIENT_QUEUE_DEPTH];
+        uint8_t head;                   // Oldest ordered message
+        uint8_t count;
+        uint32_t bytes;                 // Queued, in this client's encoding
+        bool congested;
+        unsigned long congestedSince;
+        unsigned long retryAt;
+        const char* dropReason;         // Set to disconnect the client from loop()
+    };
+    Outbox outboxes[WEBSOCKETS_SERVER_CLIENT_MAX];
+
+    // False if the client should not be written to again this pass (slow or failed)
+    bool write(uint8_t clientNum, const Outbound& message);
+    void enqueue(uint8_t clientNum, const OutboundPtr& message, uint8_t topic);
+    void flushOutboxes();
+    void clearOutbox(uint8_t clientNum);
+    void reportQueue(uint8_t clientNum);
+    size_t sizeFor(uint8_t clientNum, const Outbound& message) const;
+
+    // Log lines captured from any task, sent from loop()
+    struct LogLine {
+        unsigned long timestamp;
+        const char* level;
+        char message[WS_LOG_LINE_MAX];
+    };
+    LogLine logQueue[WS_LOG_QUEUE_DEPTH];
+    uint8_t logHead;                    // Oldest queued line
+    uint8_t logCount;
+    uint32_t logsDropped;               // Lines lost to a full queue since the last send
+    CriticalMutex logMux = CRITICAL_MUTEX_INIT;
+
+    static void logSink(const char* level, const String& message);
+    void queueLog(const char* level, const String& message);
+    void sendLogs();
+
+    // Fragmented messages collect in a pool slot, owned by the client's Reassembly,
+    // and are dispatched from the slot once WStype_FRAGMENT_FIN arrives
+    struct Reassembly {
+        bool binary;
+        bool discarding;            // Rejected; skip fragments up to the FIN
+    };
+    Reassembly reassembly[WEBSOCKETS_SERVER_CLIENT_MAX];
+    RequestBodyPool fragmentPool;
+
+    void collectFragment(uint8_t clientNum, WStype_t type, uint8_t* payload, size_t length);
+
     // WebSocket event handler
     void onWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t* payload, size_t length);
+    void dispatchMessage(uint8_t clientNum, uint8_t* payload, size_t length, bool msgpack);
 
     // Message handlers
+    void handleMessage(uint8_t clientNum, uint8_t* payload, size_t length, bool msgpack);
     void handleCommand(uint8_t clientNum, JsonDocument& doc);
+    void handleGetStatus(uint8_t clientNum, JsonVariantConst params, const String& requestId,
+                         uint8_t command, uint32_t receivedAt);
+    void submitCommand(uint8_t clientNum, const String& requestId, uint8_t index, bool async,
+                       DeviceCommand& command, uint32_t receivedAt);
+    void replyCommand(uint8_t clientNum, const String& requestId, bool success, const String& message,
+                      int metric, uint32_t receivedAt);
+    // metric indexes the WebSocket endpoints: commands in registry order, then broadcasts
+    void recordCommand(int metric, bool success, size_t bytesOut, uint32_t receivedAt);
+    void recordBroadcast(int broadcast, size_t bytesOut, uint32_t startedAt) {
+        recordCommand(commands.size() + broadcast, true, bytesOut, startedAt);
+    }
+    void completeCommands();
     void sendResponse(uint8_t clientNum, bool success, const String& message);
-    void sendToClient(uint8_t clientNum, const JsonDocument& doc);
-    void broadcast(const JsonDocument& doc);
+    size_t sendToClient(uint8_t clientNum, const JsonDocument& doc);
+
+    // Send to every client in the mask in its own encoding; each encoding is serialized once.
+    // topic decides how the message waits for a congested client. Returns the bytes sent
+    // or queued, summed over the clients.
+    size_t send(uint32_t clients, const JsonDocument& doc, uint8_t topic = TOPIC_NONE);
+    size_t sendWithStatus(uint32_t clients, const JsonDocument& envelope, const String& status,
+                          const std::vector<uint8_t>& packedStatus, uint8_t topic = TOPIC_NONE);
+    size_t deliver(uint32_t clients, const OutboundPtr& message, uint8_t topic);
+
+    // Serialize envelope with an already serialized status appended as "data"
+    String withStatus(const JsonDocument& envelope, const String& status);
+    // MessagePack version; converts the JSON status if packedStatus is empty
+    void withStatus(const JsonDocument& envelope, const String& status,
+                    const std::vector<uint8_t>& packedStatus, std::vector<uint8_t>& out);
 
     // Static wrapper for event handler (required for callback)
     static WebSocketServer* instance;
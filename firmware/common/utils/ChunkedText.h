@@ -0,0 +1,68 @@
+/**
+ * ChunkedText.h
+ * Text rendered a piece at a time into a chunked response
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef CHUNKED_TEXT_H
+#define CHUNKED_TEXT_H
+
+#include <Arduino.h>
+
+/**
+ * Base for exporters whose output is too big to hold in RAM. The derived
+ * class renders one piece at a time into text[], and read() hands it out in
+ * whatever sizes the response asks for. The buffer is a member, not a
+ * pointer, so an exporter can be copied into a response callback.
+ */
+template <size_t Size>
+class ChunkedText {
+public:
+    virtual ~ChunkedText() {}
+
+    // Fill up to maxLen bytes; returns 0 once everything has been written
+    size_t read(uint8_t* buffer, size_t maxLen) {
+        size_t written = 0;
+
+        while (written < maxLen) {
+            if (textPos >= textLen) {
+                textLen = 0;
+                textPos = 0;
+                if (!nextPiece()) {
+                    break;
+                }
+            }
+
+            size_t n = textLen - textPos;
+            if (n > maxLen - written) {
+                n = maxLen - written;
+            }
+            memcpy(buffer + written, text + textPos, n);
+            textPos += n;
+            written += n;
+        }
+
+        return written;
+    }
+
+protected:
+    ChunkedText() : textLen(0), textPos(0) {}
+
+    // Render the next piece into text[] and set textLen; false once done
+    virtual bool nextPiece() = 0;
+
+    // Take a piece snprintf() wrote to text[], cut to fit; false if there was none
+    bool setPiece(int len) {
+        if (len <= 0) {
+            return false;
+        }
+        textLen = (size_t)len < Size ? (size_t)len : Size - 1;
+        return true;
+    }
+
+    char text[Size];
+    size_t textLen;
+    size_t textPos;
+};
+
+#endif // CHUNKED_TEXT_H
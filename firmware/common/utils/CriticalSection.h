@@ -0,0 +1,47 @@
+/**
+ * CriticalSection.h
+ * Scoped lock for data shared between loop() and the network tasks
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef CRITICAL_SECTION_H
+#define CRITICAL_SECTION_H
+
+#include <Arduino.h>
+
+#ifdef ESP32
+// AsyncTCP callbacks run on their own FreeRTOS task, possibly on the other core
+typedef portMUX_TYPE CriticalMutex;
+#define CRITICAL_MUTEX_INIT portMUX_INITIALIZER_UNLOCKED
+#else
+// ESP8266 network callbacks never preempt loop(), so there is nothing to lock
+struct CriticalMutex {};
+#define CRITICAL_MUTEX_INIT {}
+#endif
+
+/**
+ * Holds the mutex for the lifetime of the object. Keep the guarded region
+ * short: no allocation, logging or blocking calls while it is held.
+ */
+class CriticalSection {
+public:
+    explicit CriticalSection(CriticalMutex& m) : mux(m) {
+#ifdef ESP32
+        portENTER_CRITICAL(&mux);
+#endif
+    }
+
+    ~CriticalSection() {
+#ifdef ESP32
+        portEXIT_CRITICAL(&mux);
+#endif
+    }
+
+private:
+    CriticalMutex& mux;
+
+    CriticalSection(const CriticalSection&);
+    CriticalSection& operator=(const CriticalSection&);
+};
+
+#endif // CRITICAL_SECTION_H
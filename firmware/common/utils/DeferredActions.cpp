@@ -0,0 +1,94 @@
+/**
+ * DeferredActions.cpp
+ * Deferred action scheduler implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "DeferredActions.h"
+#include "Logger.h"
+
+DeferredActions::DeferredActions()
+    : nextHandle(NO_ACTION) {
+    for (uint8_t i = 0; i < DEFERRED_ACTION_SLOTS; i++) {
+        slots[i].state = SLOT_FREE;
+        slots[i].handle = NO_ACTION;
+        slots[i].scheduledAt = 0;
+        slots[i].delayMs = 0;
+    }
+}
+
+DeferredActions::Handle DeferredActions::schedule(uint32_t delayMs, Action action) {
+    Slot* slot = nullptr;
+    {
+        CriticalSection lock(mux);
+        for (uint8_t i = 0; i < DEFERRED_ACTION_SLOTS; i++) {
+            if (slots[i].state == SLOT_FREE) {
+                slot = &slots[i];
+                slot->state = SLOT_CLAIMED;
+                if (++nextHandle == NO_ACTION) nextHandle++;
+                slot->handle = nextHandle;
+                break;
+            }
+        }
+    }
+
+    if (!slot) {
+        Logger::error("DeferredActions: No free slot, action dropped");
+        return NO_ACTION;
+    }
+
+    // Copying the action may allocate, so it happens outside the lock;
+    // loop() ignores the slot until it is marked waiting
+    slot->action = action;
+
+    CriticalSection lock(mux);
+    slot->scheduledAt = millis();
+    slot->delayMs = delayMs;
+    slot->state = SLOT_WAITING;
+    return slot->handle;
+}
+
+void DeferredActions::expedite(Handle handle, uint32_t delayMs) {
+    CriticalSection lock(mux);
+    Slot* slot = find(handle);
+    if (!slot || slot->state != SLOT_WAITING) {
+        return;
+    }
+
+    unsigned long now = millis();
+    uint32_t elapsed = now - slot->scheduledAt;
+    if (elapsed + delayMs < slot->delayMs) {
+        slot->scheduledAt = now;
+        slot->delayMs = delayMs;
+    }
+}
+
+void DeferredActions::loop() {
+    for (uint8_t i = 0; i < DEFERRED_ACTION_SLOTS; i++) {
+        Slot& slot = slots[i];
+        {
+            CriticalSection lock(mux);
+            if (slot.state != SLOT_WAITING || millis() - slot.scheduledAt < slot.delayMs) {
+                continue;
+            }
+            slot.state = SLOT_RUNNING;
+        }
+
+        slot.action();
+        slot.action = nullptr;
+
+        CriticalSection lock(mux);
+        slot.state = SLOT_FREE;
+    }
+}
+
+DeferredActions::Slot* DeferredActions::find(Handle handle) {
+    if (handle == NO_ACTION) return nullptr;
+
+    for (uint8_t i = 0; i < DEFERRED_ACTION_SLOTS; i++) {
+        if (slots[i].state != SLOT_FREE && slots[i].handle == handle) {
+            return &slots[i];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,62 @@
+/**
+ * DeferredActions.h
+ * Run an action from loop() after a delay, instead of blocking a callback
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef DEFERRED_ACTIONS_H
+#define DEFERRED_ACTIONS_H
+
+#include <Arduino.h>
+#include <functional>
+#include "CriticalSection.h"
+
+// Actions that can be waiting at once
+#ifndef DEFERRED_ACTION_SLOTS
+#define DEFERRED_ACTION_SLOTS 4
+#endif
+
+class DeferredActions {
+public:
+    typedef std::function<void()> Action;
+    typedef uint16_t Handle;
+
+    static const Handle NO_ACTION = 0;
+
+    DeferredActions();
+
+    // Run action from loop() once delayMs has passed. Safe to call from any
+    // task; returns NO_ACTION if every slot is taken.
+    Handle schedule(uint32_t delayMs, Action action);
+
+    // Bring a scheduled action forward to run within delayMs (never later
+    // than originally scheduled); no-op if it already ran
+    void expedite(Handle handle, uint32_t delayMs);
+
+    // Run due actions; call from the Arduino loop
+    void loop();
+
+private:
+    enum SlotState : uint8_t {
+        SLOT_FREE = 0,
+        SLOT_CLAIMED = 1,   // Being filled in by schedule()
+        SLOT_WAITING = 2,
+        SLOT_RUNNING = 3
+    };
+
+    struct Slot {
+        SlotState state;
+        Handle handle;
+        unsigned long scheduledAt;
+        uint32_t delayMs;
+        Action action;
+    };
+
+    Slot slots[DEFERRED_ACTION_SLOTS];
+    Handle nextHandle;
+    CriticalMutex mux = CRITICAL_MUTEX_INIT;
+
+    Slot* find(Handle handle);
+};
+
+#endif // DEFERRED_ACTIONS_H
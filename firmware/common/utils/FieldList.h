@@ -0,0 +1,51 @@
+/**
+ * FieldList.h
+ * Comma-separated field selection, as in ?fields=temperature,progress
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef FIELD_LIST_H
+#define FIELD_LIST_H
+
+#include <Arduino.h>
+
+class FieldList {
+public:
+    // list must outlive the FieldList; nullptr or "" selects every field
+    explicit FieldList(const char* list = nullptr) : list(list) {}
+
+    bool selectsAll() const {
+        return !list || !*list;
+    }
+
+    // True if name (len bytes, not necessarily NUL-terminated) is selected
+    bool includes(const char* name, size_t len) const {
+        if (selectsAll()) {
+            return true;
+        }
+
+        const char* p = list;
+        while (*p) {
+            while (*p == ',' || *p == ' ') p++;
+            const char* end = p;
+            while (*end && *end != ',') end++;
+            const char* last = end;
+            while (last > p && last[-1] == ' ') last--;
+
+            if ((size_t)(last - p) == len && strncmp(p, name, len) == 0) {
+                return true;
+            }
+            p = end;
+        }
+        return false;
+    }
+
+    bool includes(const char* name) const {
+        return includes(name, strlen(name));
+    }
+
+private:
+    const char* list;
+};
+
+#endif // FIELD_LIST_H
@@ -0,0 +1,46 @@
+/**
+ * Hash.h
+ * FNV-1a string hashing, usable at compile time and at runtime
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <Arduino.h>
+
+namespace Hash {
+    static constexpr uint32_t FNV_OFFSET = 2166136261u;
+    static constexpr uint32_t FNV_PRIME = 16777619u;
+
+    // Hash a NUL-terminated string (constexpr, for keys known at compile time)
+    constexpr uint32_t fnv1a(const char* s, uint32_t h = FNV_OFFSET) {
+        return *s ? fnv1a(s + 1, (h ^ (uint8_t)*s) * FNV_PRIME) : h;
+    }
+
+    // Hash len bytes (runtime, same result as the constexpr version). Named
+    // apart from fnv1a: where size_t is uint32_t (xtensa) a two-argument
+    // call would match both.
+    inline uint32_t fnv1aN(const char* s, size_t len, uint32_t h = FNV_OFFSET) {
+        for (size_t i = 0; i < len; i++) {
+            h = (h ^ (uint8_t)s[i]) * FNV_PRIME;
+        }
+        return h;
+    }
+
+    constexpr uint32_t xorShift(uint32_t h, uint8_t shift) {
+        return h ^ (h >> shift);
+    }
+
+    // MurmurHash3 finalizer: every input bit affects every output bit
+    constexpr uint32_t fmix(uint32_t h) {
+        return xorShift(xorShift(xorShift(h, 16) * 0x85EBCA6Bu, 13) * 0xC2B2AE35u, 16);
+    }
+
+    // Rehash h under a seed, for picking a collision-free perfect hash
+    constexpr uint32_t mix(uint32_t h, uint32_t seed) {
+        return fmix(h ^ (seed * 0x9E3779B9u));
+    }
+}
+
+#endif // HASH_H
@@ -8,3 +8,4 @@
 
 // Initialize static member
 Logger::Level Logger::currentLevel = Logger::INFO;
+Logger::Sink Logger::currentSink = nullptr;
@@ -18,10 +18,18 @@ public:
         ERROR = 3
     };
 
+    // Also called with every line that is printed, e.g. to forward logs to
+    // WebSocket subscribers. May run on any task: copy, don't block.
+    typedef void (*Sink)(const char* levelStr, const String& msg);
+
     static void setLevel(Level level) {
         currentLevel = level;
     }
 
+    static void setSink(Sink sink) {
+        currentSink = sink;
+    }
+
     static void debug(const String& msg) {
         log(DEBUG, "DEBUG", msg);
     }
@@ -40,6 +48,7 @@ public:
 
 private:
     static Level currentLevel;
+    static Sink currentSink;
 
     static void log(Level level, const char* levelStr, const String& msg) {
         if (level >= currentLevel) {
@@ -50,6 +59,9 @@ private:
             Serial.print(levelStr);
             Serial.print("] ");
             Serial.println(msg);
+            if (currentSink) {
+                currentSink(levelStr, msg);
+            }
         }
     }
 };
@@ -0,0 +1,52 @@
+/**
+ * SeqPage.h
+ * One page of a ring whose records carry sequence numbers, read by cursor
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef SEQ_PAGE_H
+#define SEQ_PAGE_H
+
+#include <Arduino.h>
+
+/**
+ * The records a reader gets for "everything after seq since". Records are
+ * numbered 1, 2, ... and numbers are never reused, so a cursor stays valid
+ * while the ring wraps; the reader is only told when some it never saw are
+ * gone. Shared by AlarmHistory and TelemetryHistory.
+ */
+struct SeqPage {
+    uint32_t since;         // The cursor as used; 0 if it was started over
+    uint32_t first;         // Empty if first > last
+    uint32_t last;
+    uint32_t next;          // Cursor for the following page
+    bool truncated;         // Records after since were overwritten or lost
+
+    // latest is the newest seq (0 if none), count the records still kept;
+    // limit 0 means no limit
+    static SeqPage after(uint32_t since, uint32_t limit, uint32_t latest, uint32_t count) {
+        uint32_t oldest = count > 0 ? latest - count + 1 : latest + 1;
+
+        // A cursor ahead of the ring comes from before a reboot: start over
+        SeqPage page;
+        page.truncated = since > latest || since + 1 < oldest;
+        if (since > latest) {
+            since = 0;
+        }
+
+        page.since = since;
+        page.first = since + 1 > oldest ? since + 1 : oldest;
+        page.last = latest;
+        if (limit > 0 && page.first <= page.last && page.last - page.first + 1 > limit) {
+            page.last = page.first + limit - 1;
+        }
+        page.next = page.first <= page.last ? page.last : since;
+        return page;
+    }
+
+    uint32_t size() const {
+        return first <= last ? last - first + 1 : 0;
+    }
+};
+
+#endif // SEQ_PAGE_H
@@ -0,0 +1,63 @@
+/**
+ * SpscRing.h
+ * Bounded lock-free single-producer/single-consumer ring buffer
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <utility>
+
+/**
+ * Exactly one task may push and exactly one task may pop. The producer owns
+ * tail, the consumer owns head; each only reads the other's index, so no
+ * lock is needed. N must be a power of two no larger than 128 so the free
+ * running 8-bit indices wrap cleanly.
+ */
+template <typename T, uint8_t N>
+class SpscRing {
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    // Producer: move item into the ring; false (item untouched) when full
+    bool push(T& item) {
+        uint8_t t = tail.load(std::memory_order_relaxed);
+        if ((uint8_t)(t - head.load(std::memory_order_acquire)) >= N) {
+            return false;
+        }
+        items[t & (N - 1)] = std::move(item);
+        tail.store((uint8_t)(t + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: move the oldest item out; false when empty
+    bool pop(T& item) {
+        uint8_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(items[h & (N - 1)]);
+        head.store((uint8_t)(h + 1), std::memory_order_release);
+        return true;
+    }
+
+    bool full() const {
+        return (uint8_t)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)) >= N;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static_assert(N > 0 && N <= 128 && (N & (N - 1)) == 0, "SpscRing size must be a power of two <= 128");
+
+    T items[N];
+    std::atomic<uint8_t> head;
+    std::atomic<uint8_t> tail;
+};
+
+#endif // SPSC_RING_H
@@ -8,8 +8,7 @@
 #include "../../common/utils/Logger.h"
 
 AlarmManager::AlarmManager()
-    : maxHistorySize(100),
-      tempHighDebounce(0),
+    : tempHighDebounce(0),
       tempLowDebounce(0),
       humidityLowDebounce(0),
       co2HighDebounce(0),
@@ -139,7 +138,7 @@ void AlarmManager::checkAlarms(const EnvironmentControl::EnvironmentStatus& stat
 }
 
 void AlarmManager::raiseAlarm(AlarmType type, AlarmSeverity severity,
-                             const String& message, float currentValue, float threshold) {
+                             const char* message, float currentValue, float threshold) {
     // Check if alarm already exists
     int existingIndex = findAlarmIndex(type);
     if (existingIndex >= 0) {
@@ -151,10 +150,11 @@ void AlarmManager::raiseAlarm(AlarmType type, AlarmSeverity severity,
     } else {
         // Create new alarm
         Alarm alarm(type, severity, message, currentValue, threshold);
+        alarm.seq = history.append(type, severity, message, currentValue, threshold);
         activeAlarms.push_back(alarm);
 
         String severityStr = (severity == CRITICAL) ? "CRITICAL" : "WARNING";
-        Logger::error("AlarmManager: " + severityStr + " - " + message +
+        Logger::error("AlarmManager: " + severityStr + " - " + String(message) +
                      " (Current: " + String(currentValue, 2) +
                      ", Threshold: " + String(threshold, 2) + ")");
     }
@@ -163,15 +163,8 @@ void AlarmManager::raiseAlarm(AlarmType type, AlarmSeverity severity,
 void AlarmManager::clearAlarm(AlarmType type) {
     int index = findAlarmIndex(type);
     if (index >= 0) {
-        // Move to history before removing
-        Alarm clearedAlarm = activeAlarms[index];
-        clearedAlarm.active = false;
-        alarmHistory.push_back(clearedAlarm);
-
-        // Limit history size
-        while (alarmHistory.size() > maxHistorySize) {
-            alarmHistory.erase(alarmHistory.begin());
-        }
+        // Its history record stays, marked cleared
+        history.markCleared(activeAlarms[index].seq);
 
         // Remove from active alarms
         activeAlarms.erase(activeAlarms.begin() + index);
@@ -207,17 +200,22 @@ String AlarmManager::getAlarmTypeName(AlarmType type) const {
     }
 }
 
-void AlarmManager::acknowledgeAlarm(uint8_t alarmIndex) {
-    if (alarmIndex < activeAlarms.size()) {
-        activeAlarms[alarmIndex].acknowledged = true;
-        Logger::info("AlarmManager: Alarm acknowledged - " +
-                    getAlarmTypeName(activeAlarms[alarmIndex].type));
+bool AlarmManager::acknowledgeAlarm(uint8_t alarmIndex) {
+    if (alarmIndex >= activeAlarms.size()) {
+        return false;
     }
+
+    activeAlarms[alarmIndex].acknowledged = true;
+    history.markAcknowledged(activeAlarms[alarmIndex].seq);
+    Logger::info("AlarmManager: Alarm acknowledged - " +
+                getAlarmTypeName(activeAlarms[alarmIndex].type));
+    return true;
 }
 
 void AlarmManager::acknowledgeAll() {
     for (auto& alarm : activeAlarms) {
         alarm.acknowledged = true;
+        history.markAcknowledged(alarm.seq);
     }
     if (activeAlarms.size() > 0) {
         Logger::info("AlarmManager: All " + String(activeAlarms.size()) +
@@ -226,31 +224,22 @@ void AlarmManager::acknowledgeAll() {
 }
 
 void AlarmManager::clearInactive() {
-    // Move inactive alarms to history
+    // Inactive alarms are already in the history; mark them cleared there
     auto it = activeAlarms.begin();
     while (it != activeAlarms.end()) {
         if (!it->active) {
-            alarmHistory.push_back(*it);
+            history.markCleared(it->seq);
             it = activeAlarms.erase(it);
         } else {
             ++it;
         }
     }
-
-    // Limit history size
-    while (alarmHistory.size() > maxHistorySize) {
-        alarmHistory.erase(alarmHistory.begin());
-    }
 }
 
 std::vector<AlarmManager::Alarm> AlarmManager::getActiveAlarms() const {
     return activeAlarms;
 }
 
-std::vector<AlarmManager::Alarm> AlarmManager::getAlarmHistory() const {
-    return alarmHistory;
-}
-
 uint8_t AlarmManager::getActiveAlarmCount() const {
     return activeAlarms.size();
 }
@@ -269,6 +258,6 @@ bool AlarmManager::hasCriticalAlarms() const {
 }
 
 void AlarmManager::clearHistory() {
-    alarmHistory.clear();
+    history.reset();
     Logger::info("AlarmManager: Alarm history cleared");
 }
@@ -10,6 +10,7 @@
 #include <Arduino.h>
 #include <vector>
 #include "EnvironmentControl.h"
+#include "../../common/device/AlarmHistory.h"
 
 class AlarmManager {
 public:
@@ -35,12 +36,13 @@ public:
     struct Alarm {
         AlarmType type;
         AlarmSeverity severity;
-        String message;
+        const char* message;    // Static string
         uint32_t timestamp;
         bool active;
         bool acknowledged;
         float currentValue;
         float threshold;
+        uint32_t seq;           // Record of this alarm in the history
 
         Alarm() :
             type(TEMP_HIGH),
@@ -50,9 +52,10 @@ public:
             active(false),
             acknowledged(false),
             currentValue(0.0),
-            threshold(0.0) {}
+            threshold(0.0),
+            seq(0) {}
 
-        Alarm(AlarmType t, AlarmSeverity sev, const String& msg,
+        Alarm(AlarmType t, AlarmSeverity sev, const char* msg,
              float current, float thresh) :
             type(t),
             severity(sev),
@@ -61,7 +64,8 @@ public:
             active(true),
             acknowledged(false),
             currentValue(current),
-            threshold(thresh) {}
+            threshold(thresh),
+            seq(0) {}
     };
 
     // Alarm thresholds configuration
@@ -105,26 +109,24 @@ public:
                     float tempSetpoint, float humiditySetpoint, float co2Setpoint);
 
     // Alarm management
-    void acknowledgeAlarm(uint8_t alarmIndex);
+    bool acknowledgeAlarm(uint8_t alarmIndex);   // false if there is no such active alarm
     void acknowledgeAll();
     void clearInactive();
 
     // Status queries
     std::vector<Alarm> getActiveAlarms() const;
-    std::vector<Alarm> getAlarmHistory() const;
     uint8_t getActiveAlarmCount() const;
     bool hasActiveAlarms() const;
     bool hasCriticalAlarms() const;
 
-    // Alarm history management
+    // Every alarm raised, newest ALARM_HISTORY_SIZE kept; safe to read from the network tasks
+    const AlarmHistory& getHistory() const { return history; }
     void clearHistory();
-    void setMaxHistorySize(uint16_t size) { maxHistorySize = size; }
 
 private:
     AlarmThresholds thresholds;
     std::vector<Alarm> activeAlarms;
-    std::vector<Alarm> alarmHistory;
-    uint16_t maxHistorySize;
+    AlarmHistory history;
 
     // Debouncing - alarms must persist for this many consecutive checks
     static const uint8_t DEBOUNCE_COUNT = 3;
@@ -136,7 +138,7 @@ private:
 
     // Helper methods
     void raiseAlarm(AlarmType type, AlarmSeverity severity,
-                   const String& message, float currentValue, float threshold);
+                   const char* message, float currentValue, float threshold);
     void clearAlarm(AlarmType type);
     bool isAlarmActive(AlarmType type) const;
     int findAlarmIndex(AlarmType type) const;
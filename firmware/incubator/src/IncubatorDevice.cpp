@@ -10,7 +10,10 @@
 IncubatorDevice::IncubatorDevice()
     : lastUpdate(0),
       stabilityAchievedTime(0),
-      wasStable(false) {
+      wasStable(false),
+      lastStage(0),
+      lastAlarmSeq(0),
+      lastActiveAlarms(0) {
 }
 
 void IncubatorDevice::begin() {
@@ -20,6 +23,7 @@ void IncubatorDevice::begin() {
 
     setState(IDLE);
     lastUpdate = millis();
+    publishStatus();
 
     Logger::info("IncubatorDevice: Initialized");
 }
@@ -29,6 +33,9 @@ void IncubatorDevice::loop() {
     float dt = (now - lastUpdate) / 1000.0; // Convert to seconds
 
     if (dt >= (UPDATE_INTERVAL / 1000.0)) {
+        // Apply commands queued by the network handlers
+        processCommands();
+
         // Update protocol manager
         updateProtocol();
 
@@ -43,7 +50,10 @@ void IncubatorDevice::loop() {
             checkStabilityTransition();
         }
 
+        trackTransitions();
+
         lastUpdate = now;
+        publishStatus();
     }
 }
 
@@ -137,7 +147,7 @@ JsonDocument IncubatorDevice::getStatus() {
     return doc;
 }
 
-bool IncubatorDevice::start(JsonDocument& params) {
+bool IncubatorDevice::start(JsonVariantConst params) {
     Logger::info("IncubatorDevice: Starting incubation");
 
     EnvironmentControl::EnvironmentParams envParams;
@@ -226,6 +236,24 @@ EnvironmentControl::EnvironmentParams IncubatorDevice::getEnvironmentParams() co
     return envControl.getTargets();
 }
 
+const char* IncubatorDevice::checkParams(DeviceCommand::Type type, uint8_t code, uint8_t zone, float value,
+                                         JsonVariantConst params) const {
+    if (type == DeviceCommand::TEST) {
+        return "No tests available on this device";
+    }
+    if (type != DeviceCommand::SETPOINT) {
+        return nullptr;
+    }
+
+    // Same ranges as setTemperature(), setHumidity() and setCO2()
+    switch (zone) {
+        case 0:  return value < 4.0f || value > 50.0f ? "Temperature out of range (4-50°C)" : nullptr;
+        case 1:  return value < 0.0f || value > 100.0f ? "Humidity out of range (0-100%)" : nullptr;
+        case 2:  return value < 0.0f || value > 20.0f ? "CO2 level out of range (0-20%)" : nullptr;
+        default: return "Invalid zone (0 = temperature, 1 = humidity, 2 = CO2)";
+    }
+}
+
 bool IncubatorDevice::setTemperature(float temp) {
     if (temp < 4.0 || temp > 50.0) {
         Logger::error("IncubatorDevice: Temperature out of range (4-50°C)");
@@ -274,6 +302,27 @@ bool IncubatorDevice::setCO2(float co2) {
     return true;
 }
 
+bool IncubatorDevice::isSettling() const {
+    if (state != RUNNING) {
+        return false;
+    }
+    return envControl.isRamping() || !envControl.getStatus().allStable;
+}
+
+void IncubatorDevice::trackTransitions() {
+    // Stage changes, and alarms raised or cleared, speed telemetry up for a while
+    uint8_t stage = protocolManager.getCurrentStageNumber();
+    uint32_t alarmSeq = alarmManager.getHistory().getLatestSeq();
+    uint8_t activeAlarms = alarmManager.getActiveAlarmCount();
+
+    if (stage != lastStage || alarmSeq != lastAlarmSeq || activeAlarms != lastActiveAlarms) {
+        markTransition();
+        lastStage = stage;
+        lastAlarmSeq = alarmSeq;
+        lastActiveAlarms = activeAlarms;
+    }
+}
+
 void IncubatorDevice::checkStabilityTransition() {
     EnvironmentControl::EnvironmentStatus status = envControl.getStatus();
 
@@ -398,10 +447,38 @@ bool IncubatorDevice::nextProtocolStage() {
     return false;
 }
 
-void IncubatorDevice::acknowledgeAlarm(uint8_t index) {
-    alarmManager.acknowledgeAlarm(index);
+bool IncubatorDevice::acknowledgeAlarm(uint8_t index) {
+    return alarmManager.acknowledgeAlarm(index);
 }
 
-void IncubatorDevice::acknowledgeAllAlarms() {
+bool IncubatorDevice::acknowledgeAllAlarms() {
     alarmManager.acknowledgeAll();
+    return true;
+}
+
+namespace {
+    // Registered with the WebSocket server; the protocol ops run through runCommand()
+    const CommandRegistry::Command INCUBATOR_COMMANDS[] = {
+        COMMAND("protocol_stop", DeviceCommand::DEVICE, IncubatorDevice::CMD_PROTOCOL_STOP, 0),
+        COMMAND("protocol_pause", DeviceCommand::DEVICE, IncubatorDevice::CMD_PROTOCOL_PAUSE, 0),
+        COMMAND("protocol_resume", DeviceCommand::DEVICE, IncubatorDevice::CMD_PROTOCOL_RESUME, 0),
+        COMMAND("protocol_next_stage", DeviceCommand::DEVICE, IncubatorDevice::CMD_PROTOCOL_NEXT_STAGE, 0),
+        COMMAND("ack_alarm", DeviceCommand::ACK_ALARM, 0,
+                CommandRegistry::PARAMS | CommandRegistry::REQUIRES_PARAMS),
+        COMMAND("ack_all_alarms", DeviceCommand::ACK_ALL_ALARMS, 0, 0)
+    };
+}
+
+void IncubatorDevice::registerCommands(CommandRegistry& registry) {
+    registry.add(INCUBATOR_COMMANDS, sizeof(INCUBATOR_COMMANDS) / sizeof(INCUBATOR_COMMANDS[0]));
+}
+
+bool IncubatorDevice::runCommand(uint8_t code, JsonVariantConst params) {
+    switch (code) {
+        case CMD_PROTOCOL_STOP:       return stopProtocol();
+        case CMD_PROTOCOL_PAUSE:      return pauseProtocol();
+        case CMD_PROTOCOL_RESUME:     return resumeProtocol();
+        case CMD_PROTOCOL_NEXT_STAGE: return nextProtocolStage();
+        default:                      return false;
+    }
 }
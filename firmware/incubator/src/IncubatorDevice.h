@@ -20,11 +20,16 @@ public:
     void begin() override;
     void loop() override;
     JsonDocument getStatus() override;
-    bool start(JsonDocument& params) override;
+    bool start(JsonVariantConst params) override;
     bool stop() override;
     bool pause() override;
     bool resume() override;
     bool setSetpoint(uint8_t zone, float value) override;
+    const char* checkParams(DeviceCommand::Type type, uint8_t code, uint8_t zone, float value,
+                            JsonVariantConst params) const override;
+
+    // A ramp is active or a value is outside its stability band
+    bool isSettling() const override;
 
     // Incubator-specific methods
     bool setEnvironmentParams(const EnvironmentControl::EnvironmentParams& params);
@@ -45,8 +50,19 @@ public:
     // Alarm management
     AlarmManager& getAlarmManager() { return alarmManager; }
     const AlarmManager& getAlarmManager() const { return alarmManager; }
-    void acknowledgeAlarm(uint8_t index);
-    void acknowledgeAllAlarms();
+    bool acknowledgeAlarm(uint8_t index) override;
+    bool acknowledgeAllAlarms() override;
+    const AlarmHistory* getAlarmHistory() const override { return &alarmManager.getHistory(); }
+
+    // WebSocket commands: protocol control and alarm acknowledgement
+    enum CommandCode : uint8_t {
+        CMD_PROTOCOL_STOP = 0,
+        CMD_PROTOCOL_PAUSE = 1,
+        CMD_PROTOCOL_RESUME = 2,
+        CMD_PROTOCOL_NEXT_STAGE = 3
+    };
+    void registerCommands(CommandRegistry& registry) override;
+    bool runCommand(uint8_t code, JsonVariantConst params) override;
 
 private:
     EnvironmentControl envControl;
@@ -59,8 +75,14 @@ private:
     bool wasStable;
     static const unsigned long UPDATE_INTERVAL = 100; // 100ms = 10 Hz
 
+    // Last seen protocol stage and alarm state, for reporting transitions
+    uint8_t lastStage;
+    uint32_t lastAlarmSeq;
+    uint8_t lastActiveAlarms;
+
     // Helper methods
     void checkStabilityTransition();
+    void trackTransitions();
     void updateProtocol();
     void updateAlarms();
     void applyProtocolStage(const ProtocolManager::ProtocolStage& stage);
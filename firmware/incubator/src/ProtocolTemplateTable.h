@@ -0,0 +1,100 @@
+/**
+ * ProtocolTemplateTable.h
+ * Flash-resident protocol template definitions
+ * Generated by firmware/scripts/generate_assets.py from firmware/common/assets - do not edit
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef PROTOCOL_TEMPLATE_TABLE_H
+#define PROTOCOL_TEMPLATE_TABLE_H
+
+#include <Arduino.h>
+#include "ProtocolManager.h"
+
+#define PROTOCOL_TEMPLATE_COUNT 5
+#define PROTOCOL_TEMPLATE_MAX_STAGES 3
+
+struct ProtocolTemplateStageDef {
+    char name[17];
+    float temperature;
+    float humidity;
+    float co2Level;
+    uint32_t duration;
+    bool rampToTarget;
+    uint16_t rampTime;
+};
+
+struct ProtocolTemplateDef {
+    ProtocolManager::ProtocolType type;
+    char name[29];
+    char description[61];
+    float tempAlarmHigh;
+    float tempAlarmLow;
+    float humidityAlarmLow;
+    float co2AlarmHigh;
+    float co2AlarmLow;
+    uint8_t stageCount;
+    ProtocolTemplateStageDef stages[PROTOCOL_TEMPLATE_MAX_STAGES];
+};
+
+static const ProtocolTemplateDef PROTOCOL_TEMPLATE_TABLE[PROTOCOL_TEMPLATE_COUNT] PROGMEM = {
+    {
+        ProtocolManager::MAMMALIAN_CULTURE,
+        "Mammalian Cell Culture",
+        "Standard mammalian cell culture with 30-minute pre-heat ramp",
+        38.0f, 36.0f, 90.0f, 5.5f, 4.5f,
+        2,
+        {
+            { "Pre-heat", 37.0f, 95.0f, 5.0f, 1800, true, 1800 },
+            { "Culture", 37.0f, 95.0f, 5.0f, 0, false, 0 }
+        }
+    },
+    {
+        ProtocolManager::BACTERIAL_CULTURE,
+        "Bacterial Growth (E. coli)",
+        "Standard E. coli culture with 15-minute warm-up",
+        39.0f, 35.0f, 50.0f, 6.0f, 4.0f,
+        2,
+        {
+            { "Warm-up", 37.0f, 60.0f, 5.0f, 900, true, 900 },
+            { "Growth", 37.0f, 60.0f, 5.0f, 0, false, 0 }
+        }
+    },
+    {
+        ProtocolManager::YEAST_CULTURE,
+        "Yeast Culture",
+        "Standard yeast culture at 30\302\260C with 10-minute pre-heat",
+        32.0f, 28.0f, 60.0f, 1.0f, 0.0f,
+        2,
+        {
+            { "Pre-heat", 30.0f, 70.0f, 0.04f, 600, true, 600 },
+            { "Culture", 30.0f, 70.0f, 0.04f, 0, false, 0 }
+        }
+    },
+    {
+        ProtocolManager::DECONTAMINATION,
+        "Decontamination Cycle",
+        "High-temperature cleaning cycle (65\302\260C for 2 hours)",
+        70.0f, 20.0f, 30.0f, 1.0f, 0.0f,
+        3,
+        {
+            { "Heat-up", 65.0f, 50.0f, 0.04f, 1800, true, 1800 },
+            { "Decontamination", 65.0f, 50.0f, 0.04f, 7200, false, 0 },
+            { "Cool-down", 25.0f, 50.0f, 0.04f, 3600, true, 3600 }
+        }
+    },
+    {
+        ProtocolManager::CUSTOM_PROTOCOL,
+        "Multi-Temperature Expression",
+        "Three-stage protocol for protein expression optimization",
+        40.0f, 23.0f, 55.0f, 6.0f, 4.0f,
+        3,
+        {
+            { "Initial Growth", 30.0f, 70.0f, 5.0f, 86400, true, 900 },
+            { "Expression Phase", 37.0f, 70.0f, 5.0f, 172800, true, 1800 },
+            { "Maintenance", 25.0f, 60.0f, 0.04f, 0, true, 1800 }
+        }
+    }
+};
+
+#endif // PROTOCOL_TEMPLATE_TABLE_H
@@ -12,16 +12,22 @@
 #include "../../common/wifi/WiFiManager.h"
 #include "../../common/network/HTTPServer.h"
 #include "../../common/network/WebSocketServer.h"
+#include "../../common/network/ApiMetrics.h"
+#include "../../common/network/AdmissionControl.h"
 #include "../../common/discovery/mDNSService.h"
 #include "../../common/device/DeviceIdentity.h"
 #include "../../common/utils/Logger.h"
+#include "../../common/utils/DeferredActions.h"
 
 // Global instances
 DeviceConfig config;
+DeferredActions deferredActions;
+ApiMetrics apiMetrics;
+AdmissionControl admission(config);
 WiFiManager wifiManager(config);
 IncubatorDevice incubatorDevice;
-HTTPServer httpServer(config, incubatorDevice, wifiManager);
-WebSocketServer wsServer(incubatorDevice);
+HTTPServer httpServer(config, incubatorDevice, wifiManager, deferredActions, apiMetrics, admission);
+WebSocketServer wsServer(incubatorDevice, apiMetrics, admission);
 mDNSService mdnsService(config);
 
 void setup() {
@@ -87,6 +93,16 @@ void setup() {
     wsServer.begin(config.network.wsPort);
     Logger::info("WebSocket server initialized");
 
+    // Telemetry also goes out as Server-Sent Events on the HTTP port
+    wsServer.onTelemetry([](const std::shared_ptr<const String>& message, uint32_t id) {
+        httpServer.streamTelemetry(message, id);
+    }, []() {
+        return httpServer.wantsTelemetry();
+    });
+    httpServer.onReplay([](uint32_t since, String& out) {
+        return wsServer.replayTelemetry(since, out);
+    });
+
     Logger::info("===========================================");
     Logger::info("Setup complete!");
     Logger::info("Connect to WiFi: " + config.wifi.apSSID);
@@ -116,20 +132,24 @@ void loop() {
     // Update WebSocket server
     wsServer.loop();
 
+    // Run actions deferred by network handlers (restarts, WiFi changes)
+    deferredActions.loop();
+
     // Update mDNS service
     mdnsService.loop();
 
-    // Broadcast telemetry every second
-    static unsigned long lastTelemetryBroadcast = 0;
-    if (millis() - lastTelemetryBroadcast > 1000) {
-        wsServer.broadcastTelemetry();
-        lastTelemetryBroadcast = millis();
-    }
+    // Send telemetry to each subscription whose rate is due
+    wsServer.broadcastTelemetry();
 
     // Display status periodically
     static unsigned long lastStatusPrint = 0;
     if (millis() - lastStatusPrint > 10000) { // Every 10 seconds
-        JsonDocument status = incubatorDevice.getStatus();
+        // Read the published snapshot rather than rebuilding the status
+        JsonDocument status;
+        StatusSnapshot::FramePtr snapshot = incubatorDevice.getStatusSnapshot().get();
+        if (snapshot) {
+            deserializeJson(status, snapshot->json);
+        }
 
         Logger::info("Status - WiFi: " + String(wifiManager.getState()) +
                     ", Device: " + incubatorDevice.getStateString());
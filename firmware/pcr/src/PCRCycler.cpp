@@ -10,15 +10,25 @@
 PCRCycler::PCRCycler()
     : currentPhase(IDLE),
       currentCycle(0),
-      phaseStartTime(0),
-      pauseStartTime(0),
-      totalPausedTime(0),
       running(false),
       paused(false),
-      totalProgramTime(0) {
+      lastTick(0),
+      rampMillis(0),
+      holdMillis(0),
+      holding(false),
+      runMillis(0),
+      lastTemp(0.0f),
+      sampleTemp(0.0f),
+      sampleMillis(0),
+      stepCount(0),
+      stepIndex(0),
+      predictedTotal(0),
+      predictedEndsAt(0) {
+    memset(timings, 0, sizeof(timings));
+    memset(&step, 0, sizeof(step));
 }
 
-void PCRCycler::start(const Program& program) {
+void PCRCycler::start(const Program& program, float startTemp) {
     Logger::info("PCRCycler: Starting PCR program");
     Logger::info("PCRCycler: Type=" + String(program.type) +
                 ", Cycles=" + String(program.cycles));
@@ -53,21 +63,27 @@ void PCRCycler::start(const Program& program) {
 
     programParams = program;
 
-    // Start with hot start if enabled, otherwise initial denaturation
-    if (program.hotStart.enabled) {
-        currentPhase = HOT_START;
-    } else {
-        currentPhase = INITIAL_DENATURE;
+    // Step indexes are 16 bits; at least one cycle always runs
+    if (programParams.cycles > PCR_TIMELINE_MAX_CYCLES) {
+        Logger::warning("PCRCycler: " + String(programParams.cycles) + " cycles requested, running " +
+                       String(PCR_TIMELINE_MAX_CYCLES));
+        programParams.cycles = PCR_TIMELINE_MAX_CYCLES;
+    } else if (programParams.cycles == 0) {
+        programParams.cycles = 1;
     }
 
-    currentCycle = 0;
-    phaseStartTime = millis();
-    pauseStartTime = 0;
-    totalPausedTime = 0;
+    stepCount = stepCountOf(programParams);
+    plannedRates = rampModel;
+    predictTimeline(startTemp);
+
     running = true;
     paused = false;
 
-    calculateTotalTime();
+    memset(timings, 0, sizeof(timings));
+    runMillis = 0;
+    lastTemp = startTemp;
+    predictedEndsAt = 0;
+    enterStep(0, startTemp);
 }
 
 void PCRCycler::stop() {
@@ -83,7 +99,6 @@ void PCRCycler::pause() {
         Logger::info("PCRCycler: Pausing at cycle " + String(currentCycle) +
                     ", phase " + getPhaseString());
         paused = true;
-        pauseStartTime = millis();
     }
 }
 
@@ -92,110 +107,106 @@ void PCRCycler::resume() {
         Logger::info("PCRCycler: Resuming PCR program");
         paused = false;
 
-        // Add the paused duration to total paused time
-        unsigned long pauseDuration = millis() - pauseStartTime;
-        totalPausedTime += pauseDuration;
-        pauseStartTime = 0;
+        // The phase clocks pick up from here; the pause counts towards neither
+        lastTick = millis();
     }
 }
 
-void PCRCycler::update(unsigned long now) {
+void PCRCycler::update(unsigned long now, float measuredTemp) {
     if (!running || paused || currentPhase == COMPLETE) {
         return;
     }
 
-    // Calculate elapsed time in current phase (excluding paused time)
-    unsigned long elapsed = (now - phaseStartTime - totalPausedTime) / 1000; // Convert to seconds
-    uint16_t phaseDuration = getCurrentPhaseDuration();
+    uint32_t dt = now - lastTick;
+    lastTick = now;
+    lastTemp = measuredTemp;
+    runMillis += dt;
+
+    if (!holding) {
+        rampMillis += dt;
+
+        // The hold countdown starts once the block reaches the target
+        bool reached = fabsf(measuredTemp - getCurrentTargetTemp()) <= programParams.holdBand;
+        learnRamp(measuredTemp, reached);
+        if (reached) {
+            holding = true;
+            Logger::debug("PCRCycler: " + getPhaseString() + " reached target after " +
+                         String(rampMillis) + "ms");
+        }
+        return;
+    }
+
+    holdMillis += dt;
 
     // Check if current phase is complete
-    if (elapsed >= phaseDuration) {
+    if (holdMillis / 1000 >= step.hold) {
         transitionToNextPhase();
     }
 }
 
+bool PCRCycler::isRampStalled() const {
+    return running && !holding && rampMillis >= (uint32_t)PCR_RAMP_TIMEOUT_S * 1000;
+}
+
+void PCRCycler::learnRamp(float measuredTemp, bool reached) {
+    // One span per band crossed, so each band learns its own rate
+    if (!reached && RampModel::bandOf(measuredTemp) == RampModel::bandOf(sampleTemp)) {
+        return;
+    }
+
+    if (rampModel.observe(sampleTemp, measuredTemp, rampMillis - sampleMillis)) {
+        sampleTemp = measuredTemp;
+        sampleMillis = rampMillis;
+    }
+}
+
+void PCRCycler::beginPhase() {
+    lastTick = millis();
+    rampMillis = 0;
+    holdMillis = 0;
+    sampleTemp = lastTemp;
+    sampleMillis = 0;
+
+    // The final hold has no countdown to gate
+    holding = currentPhase == HOLD;
+}
+
+void PCRCycler::enterStep(uint16_t index, float fromTemp) {
+    step = stepOf(programParams, index);
+    stepIndex = index;
+    predictedEndsAt += predictStepSeconds(fromTemp, step);
+    currentPhase = (Phase)step.phase;
+    currentCycle = step.cycle;
+    beginPhase();
+}
+
 void PCRCycler::transitionToNextPhase() {
-    Phase nextPhase = currentPhase;
-
-    switch (currentPhase) {
-        case IDLE:
-            // Should not happen
-            break;
-
-        case HOT_START:
-            Logger::info("PCRCycler: Hot start activation complete");
-            nextPhase = INITIAL_DENATURE;
-            break;
-
-        case INITIAL_DENATURE:
-            Logger::info("PCRCycler: Initial denaturation complete");
-            currentCycle = 1;
-            nextPhase = DENATURE;
-            break;
-
-        case DENATURE:
-            Logger::debug("PCRCycler: Cycle " + String(currentCycle) + " - Denaturation complete");
-
-            // Two-step PCR: skip separate anneal and extend phases
-            if (programParams.twoStepEnabled) {
-                nextPhase = ANNEAL_EXTEND;
-            } else {
-                nextPhase = ANNEAL;
-            }
-            break;
-
-        case ANNEAL:
-            Logger::debug("PCRCycler: Cycle " + String(currentCycle) + " - Annealing complete");
-            nextPhase = EXTEND;
-            break;
-
-        case EXTEND:
-            Logger::debug("PCRCycler: Cycle " + String(currentCycle) + " - Extension complete");
-
-            if (currentCycle < programParams.cycles) {
-                currentCycle++;
-                nextPhase = DENATURE;
-            } else {
-                Logger::info("PCRCycler: All cycles complete, starting final extension");
-                nextPhase = FINAL_EXTEND;
-            }
-            break;
-
-        case ANNEAL_EXTEND:
-            Logger::debug("PCRCycler: Cycle " + String(currentCycle) + " - Anneal+Extend complete");
-
-            if (currentCycle < programParams.cycles) {
-                currentCycle++;
-                nextPhase = DENATURE;
-            } else {
-                Logger::info("PCRCycler: All cycles complete, starting final extension");
-                nextPhase = FINAL_EXTEND;
-            }
-            break;
-
-        case FINAL_EXTEND:
-            Logger::info("PCRCycler: Final extension complete, moving to hold");
-            nextPhase = HOLD;
-            break;
-
-        case HOLD:
-            Logger::info("PCRCycler: PCR program complete!");
-            nextPhase = COMPLETE;
-            running = false;
-            break;
-
-        case COMPLETE:
-            // Already complete
-            break;
-    }
-
-    currentPhase = nextPhase;
-    phaseStartTime = millis();
-    totalPausedTime = 0;  // Reset for new phase
+    PhaseTiming& timing = timings[currentPhase];
+    timing.lastRampMillis = rampMillis;
+    timing.lastHoldMillis = holdMillis;
+    timing.totalRampMillis += rampMillis;
+    timing.runs++;
+
+    if (currentPhase >= DENATURE && currentPhase <= ANNEAL_EXTEND) {
+        Logger::debug("PCRCycler: Cycle " + String(currentCycle) + " - " + getPhaseString() + " complete");
+    } else {
+        Logger::info("PCRCycler: " + getPhaseString() + " complete");
+    }
+
+    // The final hold is the last step
+    if (stepIndex + 1 >= stepCount) {
+        Logger::info("PCRCycler: PCR program complete!");
+        currentPhase = COMPLETE;
+        running = false;
+        beginPhase();
+        return;
+    }
+
+    enterStep(stepIndex + 1, step.target);
 }
 
-String PCRCycler::getPhaseString() const {
-    switch (currentPhase) {
+const char* PCRCycler::phaseName(Phase phase) {
+    switch (phase) {
         case IDLE: return "IDLE";
         case HOT_START: return "HOT_START";
         case INITIAL_DENATURE: return "INITIAL_DENATURE";
@@ -210,194 +221,164 @@ String PCRCycler::getPhaseString() const {
     }
 }
 
-uint16_t PCRCycler::getCurrentPhaseDuration() const {
-    switch (currentPhase) {
-        case HOT_START: return programParams.hotStart.activationTime;
-        case INITIAL_DENATURE: return programParams.initialDenatureTime;
-        case DENATURE: return programParams.denatureTime;
-        case ANNEAL: return programParams.annealTime;
-        case EXTEND: return programParams.extendTime;
-        case ANNEAL_EXTEND: return programParams.annealExtendTime;
-        case FINAL_EXTEND: return programParams.finalExtendTime;
-        case HOLD: return 0;  // Infinite hold
-        case IDLE:
-        case COMPLETE:
-        default: return 0;
-    }
-}
-
-uint16_t PCRCycler::getPhaseTimeRemaining() const {
+uint32_t PCRCycler::getPhaseTimeRemaining() const {
     if (!running || currentPhase == IDLE || currentPhase == COMPLETE || currentPhase == HOLD) {
         return 0;
     }
 
-    unsigned long now = millis();
-
-    // Include the current ongoing pause so the countdown freezes while paused
-    unsigned long pausedTime = totalPausedTime;
-    if (paused && pauseStartTime > 0) {
-        pausedTime += (now - pauseStartTime);
+    // Frozen at the full hold while paused
+    uint32_t remaining = 0;
+    uint16_t duration = step.hold;
+    uint32_t held = holdMillis / 1000;
+    if (held < duration) {
+        remaining = duration - held;
     }
 
-    unsigned long elapsed = (now - phaseStartTime - pausedTime) / 1000;
-    uint16_t duration = getCurrentPhaseDuration();
-
-    if (elapsed >= duration) {
-        return 0;
+    // Plus the rest of the ramp, predicted from where the block is now
+    if (!holding) {
+        remaining += (predictRampMillis(rampModel, lastTemp, getCurrentTargetTemp()) + 500) / 1000;
     }
 
-    return duration - (uint16_t)elapsed;
+    return remaining;
 }
 
-uint16_t PCRCycler::getTotalTimeRemaining() const {
-    if (!running || currentPhase == COMPLETE) {
+uint32_t PCRCycler::getTotalTimeRemaining() const {
+    if (!running || currentPhase == COMPLETE || stepCount == 0) {
         return 0;
     }
 
-    uint32_t remaining = 0;
-
-    // Time remaining in current phase
-    remaining += getPhaseTimeRemaining();
-
-    // Calculate cycle time based on program type
-    uint16_t cycleTime;
-    if (programParams.twoStepEnabled) {
-        cycleTime = programParams.denatureTime + programParams.annealExtendTime;
-    } else {
-        cycleTime = programParams.denatureTime + programParams.annealTime + programParams.extendTime;
-    }
-
-    // Calculate remaining phases based on current state
-    switch (currentPhase) {
-        case HOT_START:
-            // Hot start + initial denature + all cycles + final extension
-            remaining += programParams.initialDenatureTime;
-            remaining += programParams.cycles * cycleTime;
-            remaining += programParams.finalExtendTime;
-            break;
-
-        case INITIAL_DENATURE:
-            // All cycles + final extension
-            remaining += programParams.cycles * cycleTime;
-            remaining += programParams.finalExtendTime;
-            break;
-
-        case DENATURE:
-        case ANNEAL:
-        case EXTEND:
-        case ANNEAL_EXTEND: {
-            // Remaining time in current cycle
-            if (programParams.twoStepEnabled) {
-                if (currentPhase == DENATURE) {
-                    remaining += programParams.annealExtendTime;
-                }
-            } else {
-                if (currentPhase == DENATURE) {
-                    remaining += programParams.annealTime + programParams.extendTime;
-                } else if (currentPhase == ANNEAL) {
-                    remaining += programParams.extendTime;
-                }
-            }
-
-            // Remaining cycles
-            uint16_t remainingCycles = programParams.cycles - currentCycle;
-            remaining += remainingCycles * cycleTime;
-
-            // Final extension
-            remaining += programParams.finalExtendTime;
-            break;
-        }
-
-        case FINAL_EXTEND:
-            // Just final extension remaining
-            break;
-
-        case HOLD:
-        case IDLE:
-        case COMPLETE:
-        default:
-            remaining = 0;
-            break;
-    }
-
-    return remaining;
+    // The current phase as it stands, then every later step as predicted
+    return getPhaseTimeRemaining() + predictedTotal - predictedEndsAt;
 }
 
 float PCRCycler::getProgress() const {
-    if (!running || totalProgramTime == 0) {
-        return 0.0;
-    }
-
     if (currentPhase == COMPLETE) {
         return 100.0;
     }
+    if (!running) {
+        return 0.0;
+    }
 
-    uint32_t elapsed = totalProgramTime - getTotalTimeRemaining();
-    float progress = (float)elapsed / (float)totalProgramTime * 100.0;
+    // Against time actually spent, so slow ramps slow the bar instead of
+    // making it jump back
+    uint32_t elapsed = runMillis / 1000;
+    uint32_t total = elapsed + getTotalTimeRemaining();
+    if (total == 0) {
+        return 0.0;
+    }
 
+    float progress = (float)elapsed / (float)total * 100.0;
     return constrain(progress, 0.0, 100.0);
 }
 
 float PCRCycler::getCurrentTargetTemp() const {
-    switch (currentPhase) {
-        case HOT_START: return programParams.hotStart.activationTemp;
-        case INITIAL_DENATURE: return programParams.initialDenatureTemp;
-        case DENATURE: return programParams.denatureTemp;
-        case ANNEAL: return getCurrentAnnealTemp();  // May be touchdown temperature
-        case EXTEND: return programParams.extendTemp;
-        case ANNEAL_EXTEND: return programParams.annealExtendTemp;
-        case FINAL_EXTEND: return programParams.finalExtendTemp;
-        case HOLD: return programParams.holdTemp;
-        case IDLE:
-        case COMPLETE:
-        default: return 25.0;  // Ambient
+    if (currentPhase == IDLE || currentPhase == COMPLETE) {
+        return 25.0;  // Ambient
     }
+    return step.target;
 }
 
-void PCRCycler::calculateTotalTime() {
-    totalProgramTime = 0;
+namespace {
+    PCRCycler::Step makeStep(PCRCycler::Phase phase, uint16_t cycle, float target, uint16_t hold) {
+        PCRCycler::Step step;
+        step.target = target;
+        step.hold = hold;
+        step.cycle = cycle;
+        step.phase = phase;
+        return step;
+    }
+}
+
+uint16_t PCRCycler::stepCountOf(const Program& program) {
+    // Opening steps, the cycles, final extend and hold
+    uint16_t opening = program.hotStart.enabled ? 2 : 1;
+    uint16_t perCycle = program.twoStepEnabled ? 2 : 3;
+    return opening + program.cycles * perCycle + 2;
+}
 
-    // Hot start (if enabled)
-    if (programParams.hotStart.enabled) {
-        totalProgramTime += programParams.hotStart.activationTime;
+PCRCycler::Step PCRCycler::stepOf(const Program& program, uint16_t index) {
+    if (program.hotStart.enabled) {
+        if (index == 0) {
+            return makeStep(HOT_START, 0, program.hotStart.activationTemp, program.hotStart.activationTime);
+        }
+        index--;
+    }
+    if (index == 0) {
+        return makeStep(INITIAL_DENATURE, 0, program.initialDenatureTemp, program.initialDenatureTime);
+    }
+    index--;
+
+    uint16_t perCycle = program.twoStepEnabled ? 2 : 3;
+    if (index < program.cycles * perCycle) {
+        uint16_t cycle = index / perCycle + 1;
+        switch (index % perCycle) {
+            case 0:
+                return makeStep(DENATURE, cycle, program.denatureTemp, program.denatureTime);
+            case 1:
+                // Two-step PCR: combined anneal and extend
+                if (program.twoStepEnabled) {
+                    return makeStep(ANNEAL_EXTEND, cycle, program.annealExtendTemp, program.annealExtendTime);
+                }
+                return makeStep(ANNEAL, cycle, annealTempFor(program, cycle), program.annealTime);
+            default:
+                return makeStep(EXTEND, cycle, program.extendTemp, program.extendTime);
+        }
     }
 
-    // Initial denaturation
-    totalProgramTime += programParams.initialDenatureTime;
+    if (index == program.cycles * perCycle) {
+        return makeStep(FINAL_EXTEND, program.cycles, program.finalExtendTemp, program.finalExtendTime);
+    }
+    return makeStep(HOLD, program.cycles, program.holdTemp, 0);
+}
 
-    // Cycling - depends on program type
-    if (programParams.twoStepEnabled) {
-        totalProgramTime += programParams.cycles * (programParams.denatureTime +
-                                                    programParams.annealExtendTime);
-    } else {
-        totalProgramTime += programParams.cycles * (programParams.denatureTime +
-                                                    programParams.annealTime +
-                                                    programParams.extendTime);
+void PCRCycler::predictTimeline(float startTemp) {
+    // Every ramp from the previous target at the learned rates, plus the
+    // hold. The final hold is not waited for. enterStep() adds up the same
+    // terms as the run goes, so what is left is the difference.
+    predictedTotal = 0;
+    float temp = startTemp;
+    for (uint16_t i = 0; i < stepCount; i++) {
+        Step next = stepOf(programParams, i);
+        predictedTotal += predictStepSeconds(temp, next);
+        if (next.phase != HOLD) {
+            temp = next.target;
+        }
     }
 
-    // Final extension
-    totalProgramTime += programParams.finalExtendTime;
+    Logger::info("PCRCycler: " + String(stepCount) + " steps, predicted program time = " +
+                String(predictedTotal) + " seconds (" + String(predictedTotal / 60) + " minutes)");
+}
 
-    // Note: Hold is infinite, so not included in total time
+uint32_t PCRCycler::predictStepSeconds(float fromTemp, const Step& to) const {
+    if (to.phase == HOLD) {
+        return 0;
+    }
+    return (predictRampMillis(plannedRates, fromTemp, to.target) + 500) / 1000 + to.hold;
+}
 
-    Logger::info("PCRCycler: Total program time = " + String(totalProgramTime) + " seconds (" +
-                String(totalProgramTime / 60) + " minutes)");
+uint32_t PCRCycler::predictRampMillis(const RampModel& rates, float fromTemp, float toTemp) const {
+    // The ramp ends, and the hold starts, on entering the hold band
+    float band = programParams.holdBand;
+    if (fabsf(toTemp - fromTemp) <= band) {
+        return 0;
+    }
+    return rates.predictMillis(fromTemp, toTemp > fromTemp ? toTemp - band : toTemp + band);
 }
 
-float PCRCycler::calculateTouchdownTemp() const {
-    if (!programParams.touchdown.enabled) {
-        return programParams.annealTemp;
+float PCRCycler::annealTempFor(const Program& program, uint16_t cycle) {
+    if (!program.touchdown.enabled) {
+        return program.annealTemp;
     }
 
-    // Calculate touchdown temperature based on current cycle
-    if (currentCycle <= programParams.touchdown.touchdownCycles) {
-        float tempDecrease = (currentCycle - 1) * programParams.touchdown.stepSize;
-        float currentTemp = programParams.touchdown.startAnnealTemp - tempDecrease;
-        return constrain(currentTemp, programParams.touchdown.endAnnealTemp, programParams.touchdown.startAnnealTemp);
+    // Touchdown: step down from the start temperature each cycle
+    if (cycle <= program.touchdown.touchdownCycles) {
+        float tempDecrease = (cycle - 1) * program.touchdown.stepSize;
+        float currentTemp = program.touchdown.startAnnealTemp - tempDecrease;
+        return constrain(currentTemp, program.touchdown.endAnnealTemp, program.touchdown.startAnnealTemp);
     }
 
     // After touchdown cycles, use final temperature
-    return programParams.touchdown.endAnnealTemp;
+    return program.touchdown.endAnnealTemp;
 }
 
 float PCRCycler::calculateGradientTemp(uint8_t position) const {
@@ -418,10 +399,5 @@ float PCRCycler::calculateGradientTemp(uint8_t position) const {
 
 float PCRCycler::getCurrentAnnealTemp() const {
     // Touchdown takes precedence over standard annealing temp
-    if (programParams.touchdown.enabled) {
-        return calculateTouchdownTemp();
-    }
-
-    // Otherwise use standard annealing temperature
-    return programParams.annealTemp;
+    return annealTempFor(programParams, currentCycle);
 }
@@ -8,6 +8,33 @@
 #define PCR_CYCLER_H
 
 #include <Arduino.h>
+#include "RampModel.h"
+
+// A phase's hold countdown starts once the block is within this many °C of
+// its target (per program: Program::holdBand)
+#ifndef PCR_SETTLED_BAND
+#define PCR_SETTLED_BAND 1.0f
+#endif
+
+// Accepted range for Program::holdBand (°C): tighter never settles under
+// sensor noise, wider starts holds long before the block is at temperature
+#ifndef PCR_HOLD_BAND_MIN
+#define PCR_HOLD_BAND_MIN 0.1f
+#endif
+
+#ifndef PCR_HOLD_BAND_MAX
+#define PCR_HOLD_BAND_MAX 5.0f
+#endif
+
+// Longest a ramp may take before the run is abandoned (heater or fan fault)
+#ifndef PCR_RAMP_TIMEOUT_S
+#define PCR_RAMP_TIMEOUT_S 300
+#endif
+
+// Longest program run; longer ones are cut to this
+#ifndef PCR_TIMELINE_MAX_CYCLES
+#define PCR_TIMELINE_MAX_CYCLES 100
+#endif
 
 class PCRCycler {
 public:
@@ -107,6 +134,9 @@ public:
         // Hold
         float holdTemp;
 
+        // Hold timers start within this many °C of the phase target
+        float holdBand;
+
         // Gradient PCR
         GradientConfig gradient;
 
@@ -129,25 +159,56 @@ public:
             annealExtendTime(45),
             finalExtendTemp(72.0),
             finalExtendTime(300),  // 5 minutes
-            holdTemp(4.0) {}
+            holdTemp(4.0),
+            holdBand(PCR_SETTLED_BAND) {}
+    };
+
+    // Measured ramp and hold of one phase type over the current run
+    struct PhaseTiming {
+        uint32_t lastRampMillis;    // Ramp of its most recent run
+        uint32_t lastHoldMillis;
+        uint32_t totalRampMillis;   // Over every run, for the mean
+        uint16_t runs;
+    };
+
+    // One phase of the program as run, in order. A program is its opening
+    // steps, the per-cycle steps once per cycle, then final extend and hold;
+    // steps are worked out from it by index, so none are stored.
+    struct Step {
+        float target;       // °C
+        uint16_t hold;      // Seconds
+        uint16_t cycle;     // 0 before cycling starts
+        uint8_t phase;
     };
 
     PCRCycler();
 
-    // Control methods
-    void start(const Program& program);
+    // Control methods; startTemp is the block temperature the first ramp starts from
+    void start(const Program& program, float startTemp);
     void stop();
     void pause();
     void resume();
-    void update(unsigned long now);
+
+    // Each phase but HOLD runs as a ramp, until measuredTemp is within the
+    // program's holdBand of the target, then a hold of the programmed time.
+    // Paused time counts towards neither.
+    void update(unsigned long now, float measuredTemp);
 
     // Status methods
     Phase getCurrentPhase() const { return currentPhase; }
-    String getPhaseString() const;
+    String getPhaseString() const { return phaseName(currentPhase); }
+    static const char* phaseName(Phase phase);
+    bool isHolding() const { return holding; }
+    uint32_t getRampMillis() const { return rampMillis; }   // Current phase
+    uint32_t getHoldMillis() const { return holdMillis; }
+    const PhaseTiming& getPhaseTiming(Phase phase) const { return timings[phase]; }
+    bool isRampStalled() const;     // Still ramping after PCR_RAMP_TIMEOUT_S
     uint16_t getCurrentCycle() const { return currentCycle; }
     uint16_t getTotalCycles() const { return programParams.cycles; }
-    uint16_t getPhaseTimeRemaining() const;
-    uint16_t getTotalTimeRemaining() const;
+
+    // Estimates from the step times predicted at start(), ramps included
+    uint32_t getPhaseTimeRemaining() const;
+    uint32_t getTotalTimeRemaining() const;
     float getProgress() const;
     bool isRunning() const { return running && !paused; }
     bool isPaused() const { return paused; }
@@ -157,26 +218,64 @@ public:
     float getCurrentTargetTemp() const;
 
     // Advanced feature calculations
-    float calculateTouchdownTemp() const;
     float calculateGradientTemp(uint8_t position) const;
     float getCurrentAnnealTemp() const;  // Returns actual anneal temp (touchdown or standard)
 
+    // Program timeline
+    uint16_t getStepCount() const { return stepCount; }
+    uint16_t getStepIndex() const { return stepIndex; }     // Current step
+    Step getStep(uint16_t index) const { return stepOf(programParams, index); }
+
+    // A program's steps, touchdown resolved per cycle; indexes past the
+    // end give the final hold
+    static uint16_t stepCountOf(const Program& program);
+    static Step stepOf(const Program& program, uint16_t index);
+
+    // Ramp rates learned from this and earlier runs
+    RampModel& getRampModel() { return rampModel; }
+
 private:
     Program programParams;
     Phase currentPhase;
     uint16_t currentCycle;
-    unsigned long phaseStartTime;
-    unsigned long pauseStartTime;
-    unsigned long totalPausedTime;
     bool running;
     bool paused;
 
+    // Current phase clocks, advanced by update() while running
+    unsigned long lastTick;
+    uint32_t rampMillis;
+    uint32_t holdMillis;
+    bool holding;               // Target reached; the hold countdown is running
+    PhaseTiming timings[COMPLETE + 1];
+    uint32_t runMillis;         // Running time of the program, pauses excluded
+
+    // Ramp rate learning: the span of the current ramp not yet folded into the model
+    RampModel rampModel;
+    float lastTemp;             // Measured at the last update()
+    float sampleTemp;
+    uint32_t sampleMillis;      // Ramp clock at sampleTemp
+
+    // Position in the program. Step times are predicted from each step's
+    // previous target with the rates as they were at start(), so the ones
+    // enterStep() adds up agree with the total.
+    Step step;                  // Current
+    uint16_t stepCount;
+    uint16_t stepIndex;
+    uint32_t predictedTotal;    // Seconds, program start to the final hold
+    uint32_t predictedEndsAt;   // Seconds, program start to the end of the current step
+    RampModel plannedRates;
+
     // Phase transitions
     void transitionToNextPhase();
-    uint16_t getCurrentPhaseDuration() const;
-    void calculateTotalTime();
+    void enterStep(uint16_t index, float fromTemp);
+    void beginPhase();          // Restart the phase clocks
+    void learnRamp(float measuredTemp, bool reached);
 
-    uint32_t totalProgramTime;  // Total time in seconds
+    // Timeline
+    void predictTimeline(float startTemp);
+    uint32_t predictStepSeconds(float fromTemp, const Step& to) const;
+    uint32_t predictRampMillis(const RampModel& rates, float fromTemp, float toTemp) const;
+    static float annealTempFor(const Program& program, uint16_t cycle);
 };
 
 #endif // PCR_CYCLER_H
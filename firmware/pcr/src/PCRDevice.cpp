@@ -10,7 +10,8 @@
 #include <math.h>
 
 PCRDevice::PCRDevice()
-    : currentTemp(0.0f),
+    : lastPhase(PCRCycler::IDLE),
+      currentTemp(0.0f),
       targetTemp(0.0f),
       heaterOn(false),
       fanOn(false),
@@ -42,9 +43,13 @@ void PCRDevice::begin() {
 
     currentProgram = PCRCycler::Program();  // default 95/60/72°C, 35 cycles
 
+    // Ramp rates learned on earlier runs, for time estimates
+    cycler.getRampModel().load();
+
     // Take an initial temperature reading
     currentTemp = readTemperature();
     Logger::info("PCRDevice: Ambient temp = " + String(currentTemp, 1) + " °C");
+    publishStatus();
     Logger::info("PCRDevice: Ready — Heater=D5(GPIO14) Fan=D6(GPIO12) Sensor=A0");
 }
 
@@ -73,15 +78,35 @@ void PCRDevice::loop() {
         float dt = (now - lastUpdate) / 1000.0f;
         lastUpdate = now;
 
+        // Apply commands queued by the network handlers
+        processCommands();
+
         if (state == RUNNING) {
             // Advance the PCR state machine
-            cycler.update(now);
+            cycler.update(now, currentTemp);
+            if (cycler.getCurrentPhase() != lastPhase) {
+                lastPhase = cycler.getCurrentPhase();
+                markTransition();
+            }
+
+            // A block that never reaches its target has a heater or fan fault
+            if (cycler.isRampStalled()) {
+                Logger::error("PCRDevice: " + cycler.getPhaseString() + " target not reached in " +
+                              String(PCR_RAMP_TIMEOUT_S) + "s — shutting down");
+                cycler.stop();
+                allOff();
+                setState(ERROR);
+                publishStatus();
+                return;
+            }
 
             // Check for program completion
             if (cycler.isComplete()) {
                 Logger::info("PCRDevice: PCR program complete");
                 allOff();
+                saveRampModel();
                 setState(IDLE);
+                publishStatus();
                 return;
             }
 
@@ -112,6 +137,8 @@ void PCRDevice::loop() {
             pidIntegral  = 0.0f;
             pidPrevError = 0.0f;
         }
+
+        publishStatus();
     }
 }
 
@@ -140,16 +167,27 @@ JsonDocument PCRDevice::getStatus() {
         doc["totalCycles"]        = cycler.getTotalCycles();
         doc["phaseTimeRemaining"] = cycler.getPhaseTimeRemaining();
         doc["totalTimeRemaining"] = cycler.getTotalTimeRemaining();
+        doc["eta"]                = getUptime() + cycler.getTotalTimeRemaining();
         doc["progress"]           = cycler.getProgress();
+        doc["phaseStep"]          = cycler.isHolding() ? "HOLD" : "RAMP";
+        doc["rampTime"]           = cycler.getRampMillis() / 1000.0f;
+        doc["holdTime"]           = cycler.getHoldMillis() / 1000.0f;
     } else {
         doc["currentPhase"]       = "IDLE";
         doc["cycleNumber"]        = 0;
         doc["totalCycles"]        = 0;
         doc["phaseTimeRemaining"] = 0;
         doc["totalTimeRemaining"] = 0;
+        doc["eta"]                = 0;
         doc["progress"]           = 0.0f;
+        doc["phaseStep"]          = "IDLE";
+        doc["rampTime"]           = 0.0f;
+        doc["holdTime"]           = 0.0f;
     }
 
+    // Measured ramp and hold per phase, kept after the run ends until the next start
+    addPhaseTimings(doc["phaseTimings"].to<JsonObject>());
+
     // Program parameters
     JsonObject prog = doc["program"].to<JsonObject>();
     prog["name"]              = currentProgramName;
@@ -163,42 +201,35 @@ JsonDocument PCRDevice::getStatus() {
     prog["extendTime"]        = currentProgram.extendTime;
     prog["annealExtendTemp"]  = currentProgram.annealExtendTemp;
     prog["annealExtendTime"]  = currentProgram.annealExtendTime;
+    prog["holdBand"]          = currentProgram.holdBand;
 
     doc["errors"].to<JsonArray>();  // empty array
 
     return doc;
 }
 
-bool PCRDevice::start(JsonDocument& params) {
-    Logger::info("PCRDevice: Starting PCR program");
+void PCRDevice::addPhaseTimings(JsonObject timings) const {
+    for (uint8_t p = PCRCycler::HOT_START; p <= PCRCycler::FINAL_EXTEND; p++) {
+        PCRCycler::Phase phase = (PCRCycler::Phase)p;
+        const PCRCycler::PhaseTiming& timing = cycler.getPhaseTiming(phase);
+        if (timing.runs == 0) {
+            continue;
+        }
 
-    // Store program name sent by app (e.g. "Standard PCR", "Colony PCR")
-    if (!params["name"].isNull()) {
-        currentProgramName = params["name"].as<String>();
+        JsonObject entry = timings[PCRCycler::phaseName(phase)].to<JsonObject>();
+        entry["ramp"]    = timing.lastRampMillis / 1000.0f;
+        entry["hold"]    = timing.lastHoldMillis / 1000.0f;
+        entry["avgRamp"] = timing.totalRampMillis / 1000.0f / timing.runs;
+        entry["runs"]    = timing.runs;
     }
+}
 
-    // Parse optional overrides from app
-    if (!params["cycles"].isNull())        currentProgram.cycles         = params["cycles"];
-    if (!params["denatureTemp"].isNull())  currentProgram.denatureTemp   = params["denatureTemp"];
-    if (!params["denatureTime"].isNull())  currentProgram.denatureTime   = params["denatureTime"];
-    if (!params["annealTemp"].isNull())    currentProgram.annealTemp     = params["annealTemp"];
-    if (!params["annealTime"].isNull())    currentProgram.annealTime     = params["annealTime"];
-    if (!params["extendTemp"].isNull())    currentProgram.extendTemp     = params["extendTemp"];
-    if (!params["extendTime"].isNull())    currentProgram.extendTime     = params["extendTime"];
-    if (!params["initialDenatureTemp"].isNull()) currentProgram.initialDenatureTemp = params["initialDenatureTemp"];
-    if (!params["initialDenatureTime"].isNull()) currentProgram.initialDenatureTime = params["initialDenatureTime"];
-    if (!params["finalExtendTemp"].isNull())     currentProgram.finalExtendTemp     = params["finalExtendTemp"];
-    if (!params["finalExtendTime"].isNull())     currentProgram.finalExtendTime     = params["finalExtendTime"];
-    if (!params["annealExtendTemp"].isNull())    currentProgram.annealExtendTemp    = params["annealExtendTemp"];
-    if (!params["annealExtendTime"].isNull())    currentProgram.annealExtendTime    = params["annealExtendTime"];
+bool PCRDevice::start(JsonVariantConst params) {
+    Logger::info("PCRDevice: Starting PCR program");
 
-    // Apply program type: support standard and two-step; gradient/touchdown not supported on single zone
-    if (!params["type"].isNull() && params["type"].as<String>() == "twostep") {
-        currentProgram.type           = PCRCycler::TWOSTEP_PCR;
-        currentProgram.twoStepEnabled = true;
-    } else {
-        currentProgram.type           = PCRCycler::STANDARD_PCR;
-        currentProgram.twoStepEnabled = false;
+    // Without parameters the loaded program runs as it is
+    if (!params.isNull() && params.size() > 0) {
+        applyProgram(params);
     }
     currentProgram.hotStart.enabled = false;
 
@@ -209,7 +240,7 @@ bool PCRDevice::start(JsonDocument& params) {
     pidIntegral  = 0.0f;
     pidPrevError = 0.0f;
 
-    cycler.start(currentProgram);
+    cycler.start(currentProgram, currentTemp);
     setState(RUNNING);
 
     if (currentProgram.twoStepEnabled) {
@@ -230,6 +261,7 @@ bool PCRDevice::stop() {
     Logger::info("PCRDevice: Stopping");
     cycler.stop();
     allOff();
+    saveRampModel();
     targetTemp   = 0.0f;
     pidIntegral  = 0.0f;
     pidPrevError = 0.0f;
@@ -269,14 +301,131 @@ bool PCRDevice::setSetpoint(uint8_t zone, float value) {
     return true;
 }
 
+bool PCRDevice::isSettling() const {
+    // Paused, the block is only held at its target and the run does not
+    // advance, so it streams at the steady rate
+    if (state != RUNNING) {
+        return false;
+    }
+    return !cycler.isHolding();
+}
+
+// Keep what this run learned about ramp rates; written once per run to spare the flash
+void PCRDevice::saveRampModel() {
+    if (cycler.getRampModel().isDirty()) {
+        cycler.getRampModel().save();
+    }
+}
+
 bool PCRDevice::loadProgram(const PCRCycler::Program& program) {
     currentProgram = program;
     return true;
 }
 
+// Overlay the app's program fields on the current program
+void PCRDevice::applyProgram(JsonVariantConst params) {
+    // Store program name sent by app (e.g. "Standard PCR", "Colony PCR")
+    if (!params["name"].isNull()) {
+        currentProgramName = params["name"].as<String>();
+    }
+
+    // Parse optional overrides from app
+    if (!params["cycles"].isNull())        currentProgram.cycles         = params["cycles"];
+    if (!params["denatureTemp"].isNull())  currentProgram.denatureTemp   = params["denatureTemp"];
+    if (!params["denatureTime"].isNull())  currentProgram.denatureTime   = params["denatureTime"];
+    if (!params["annealTemp"].isNull())    currentProgram.annealTemp     = params["annealTemp"];
+    if (!params["annealTime"].isNull())    currentProgram.annealTime     = params["annealTime"];
+    if (!params["extendTemp"].isNull())    currentProgram.extendTemp     = params["extendTemp"];
+    if (!params["extendTime"].isNull())    currentProgram.extendTime     = params["extendTime"];
+    if (!params["initialDenatureTemp"].isNull()) currentProgram.initialDenatureTemp = params["initialDenatureTemp"];
+    if (!params["initialDenatureTime"].isNull()) currentProgram.initialDenatureTime = params["initialDenatureTime"];
+    if (!params["finalExtendTemp"].isNull())     currentProgram.finalExtendTemp     = params["finalExtendTemp"];
+    if (!params["finalExtendTime"].isNull())     currentProgram.finalExtendTime     = params["finalExtendTime"];
+    if (!params["annealExtendTemp"].isNull())    currentProgram.annealExtendTemp    = params["annealExtendTemp"];
+    if (!params["annealExtendTime"].isNull())    currentProgram.annealExtendTime    = params["annealExtendTime"];
+
+    // Vetted by checkParams() on the way in; anything else is ignored, not clamped
+    float holdBand = params["holdBand"] | 0.0f;
+    if (holdBand >= PCR_HOLD_BAND_MIN && holdBand <= PCR_HOLD_BAND_MAX) {
+        currentProgram.holdBand = holdBand;
+    } else if (!params["holdBand"].isNull()) {
+        Logger::warning("PCRDevice: Ignoring holdBand " + params["holdBand"].as<String>());
+    }
+
+    // Apply program type: support standard and two-step; gradient/touchdown not supported on single zone
+    if (!params["type"].isNull() && params["type"].as<String>() == "twostep") {
+        currentProgram.type           = PCRCycler::TWOSTEP_PCR;
+        currentProgram.twoStepEnabled = true;
+    } else {
+        currentProgram.type           = PCRCycler::STANDARD_PCR;
+        currentProgram.twoStepEnabled = false;
+    }
+}
+
+// ─── WebSocket Commands ──────────────────────────────────────────────────────
+
+namespace {
+    const CommandRegistry::Command PCR_COMMANDS[] = {
+        COMMAND("load_program", DeviceCommand::DEVICE, PCRDevice::CMD_LOAD_PROGRAM,
+                CommandRegistry::PARAMS | CommandRegistry::REQUIRES_PARAMS | CommandRegistry::LONG_RUNNING)
+    };
+}
+
+void PCRDevice::registerCommands(CommandRegistry& registry) {
+    registry.add(PCR_COMMANDS, sizeof(PCR_COMMANDS) / sizeof(PCR_COMMANDS[0]));
+}
+
+bool PCRDevice::runCommand(uint8_t code, JsonVariantConst params) {
+    switch (code) {
+        case CMD_LOAD_PROGRAM:
+            // Replacing the program under a running cycler would desync its phases
+            if (state == RUNNING || state == PAUSED) {
+                Logger::warning("PCRDevice: Cannot load a program while one is active");
+                return false;
+            }
+            applyProgram(params);
+            Logger::info("PCRDevice: Loaded program " + currentProgramName);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+const char* PCRDevice::checkParams(DeviceCommand::Type type, uint8_t code, uint8_t zone, float value,
+                                   JsonVariantConst params) const {
+    // Same limits as setSetpoint() and runTest()
+    if (type == DeviceCommand::SETPOINT && zone != 0) {
+        return "PCR has a single zone (0)";
+    }
+    if (type == DeviceCommand::TEST && params["component"] != "fan") {
+        return "Unknown test component";
+    }
+
+    bool program = type == DeviceCommand::START ||
+                   (type == DeviceCommand::DEVICE && code == CMD_LOAD_PROGRAM);
+    if (!program) {
+        return nullptr;
+    }
+
+    JsonVariantConst holdBand = params["holdBand"];
+    if (!holdBand.isNull()) {
+        float band = holdBand | 0.0f;
+        if (!holdBand.is<float>() || band < PCR_HOLD_BAND_MIN || band > PCR_HOLD_BAND_MAX) {
+            return "holdBand must be between 0.1 and 5 °C";
+        }
+    }
+    return nullptr;
+}
+
+bool PCRDevice::allowedIn(State state, DeviceCommand::Type type, JsonVariantConst params) const {
+    // The fan test would fight the thermal control of a program
+    return type != DeviceCommand::TEST || (state != RUNNING && state != PAUSED);
+}
+
 // ─── Diagnostic Tests ─────────────────────────────────────────────────────────
 
-bool PCRDevice::runTest(JsonDocument& params) {
+bool PCRDevice::runTest(JsonVariantConst params) {
     String component = params["component"].as<String>();
 
     if (component == "fan") {
@@ -37,7 +37,7 @@ public:
     void begin()               override;
     void loop()                override;
     JsonDocument getStatus()   override;
-    bool start(JsonDocument& params) override;
+    bool start(JsonVariantConst params) override;
     bool stop()                override;
     bool pause()               override;
     bool resume()              override;
@@ -45,7 +45,21 @@ public:
 
     // Diagnostic tests — called by POST /api/v1/device/test
     // Supported: {"component":"fan"}  →  fan runs for 10 s then auto-stops
-    bool runTest(JsonDocument& params) override;
+    bool runTest(JsonVariantConst params) override;
+
+    // Still ramping towards the phase target (hold not yet started)
+    bool isSettling() const override;
+
+    // WebSocket commands: load_program stores a program for a later
+    // parameterless start, without running it
+    enum CommandCode : uint8_t {
+        CMD_LOAD_PROGRAM = 0
+    };
+    void registerCommands(CommandRegistry& registry) override;
+    bool runCommand(uint8_t code, JsonVariantConst params) override;
+    const char* checkParams(DeviceCommand::Type type, uint8_t code, uint8_t zone, float value,
+                            JsonVariantConst params) const override;
+    bool allowedIn(State state, DeviceCommand::Type type, JsonVariantConst params) const override;
 
     // PCR-specific
     bool loadProgram(const PCRCycler::Program& program);
@@ -60,6 +74,7 @@ public:
 private:
     PCRCycler          cycler;
     PCRCycler::Program currentProgram;
+    PCRCycler::Phase   lastPhase;     // Phase seen on the previous tick, for transitions
 
     // Temperature
     float currentTemp;   // °C, read from NTC3950
@@ -88,6 +103,9 @@ private:
     String currentProgramName;
 
     // Internal helpers
+    void  applyProgram(JsonVariantConst params);
+    void  addPhaseTimings(JsonObject timings) const;
+    void  saveRampModel();
     float readTemperature();
     void  updatePID(float dt);
     void  setHeater(int pwmValue);   // 0-255
@@ -0,0 +1,180 @@
+/**
+ * RampModel.cpp
+ * Ramp rate model implementation
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#include "RampModel.h"
+#include "../../common/utils/Logger.h"
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+
+namespace {
+    // Shorter spans are dominated by sensor noise
+    const float MIN_SPAN_C = 2.0f;
+    const uint32_t MIN_SPAN_MS = 1000;
+
+    // Measured rates outside this range are treated as glitches (°C/s)
+    const float MIN_RATE = 0.05f;
+    const float MAX_RATE = 20.0f;
+
+    // Least weight a new span gets, so old runs fade out of the average
+    const float MIN_WEIGHT = 0.2f;
+}
+
+const char* RampModel::MODEL_FILE = "/ramp_model.json";
+
+RampModel::RampModel() {
+    reset();
+}
+
+void RampModel::reset() {
+    for (uint8_t band = 0; band < RAMP_MODEL_BANDS; band++) {
+        rates[HEATING][band] = RAMP_MODEL_DEFAULT_HEATING;
+        rates[COOLING][band] = RAMP_MODEL_DEFAULT_COOLING;
+        samples[HEATING][band] = 0;
+        samples[COOLING][band] = 0;
+    }
+    dirty = false;
+}
+
+uint8_t RampModel::bandOf(float temp) {
+    if (temp <= 0.0f) {
+        return 0;
+    }
+    uint16_t band = (uint16_t)(temp / RAMP_MODEL_BAND_C);
+    return band < RAMP_MODEL_BANDS ? band : RAMP_MODEL_BANDS - 1;
+}
+
+bool RampModel::observe(float fromTemp, float toTemp, uint32_t elapsedMillis) {
+    float span = fabsf(toTemp - fromTemp);
+    if (span < MIN_SPAN_C || elapsedMillis < MIN_SPAN_MS) {
+        return false;
+    }
+
+    float rate = span * 1000.0f / elapsedMillis;
+    if (rate < MIN_RATE || rate > MAX_RATE) {
+        return false;
+    }
+
+    Direction direction = toTemp > fromTemp ? HEATING : COOLING;
+    uint8_t band = bandOf((fromTemp + toTemp) / 2.0f);
+
+    // Plain mean over the first few spans (the first replaces the default),
+    // then an exponential average
+    uint8_t& count = samples[direction][band];
+    float weight = 1.0f / (count + 1);
+    if (weight < MIN_WEIGHT) {
+        weight = MIN_WEIGHT;
+    }
+    rates[direction][band] += (rate - rates[direction][band]) * weight;
+    if (count < 255) {
+        count++;
+    }
+
+    dirty = true;
+    return true;
+}
+
+uint32_t RampModel::predictMillis(float fromTemp, float toTemp) const {
+    Direction direction = toTemp > fromTemp ? HEATING : COOLING;
+    float low = direction == HEATING ? fromTemp : toTemp;
+    float high = direction == HEATING ? toTemp : fromTemp;
+
+    // Each band crossed contributes its share of the span at its own rate
+    float seconds = 0.0f;
+    for (float temp = low; temp < high; ) {
+        uint8_t band = bandOf(temp);
+        float edge = band == RAMP_MODEL_BANDS - 1 ? high : (band + 1) * (float)RAMP_MODEL_BAND_C;
+        if (edge > high) {
+            edge = high;
+        }
+        seconds += (edge - temp) / rates[direction][band];
+        temp = edge;
+    }
+
+    return (uint32_t)(seconds * 1000.0f);
+}
+
+bool RampModel::load() {
+    if (!LittleFS.begin()) {
+        Logger::error("RampModel: Failed to mount filesystem");
+        return false;
+    }
+
+    if (!LittleFS.exists(MODEL_FILE)) {
+        Logger::info("RampModel: No saved model, using default rates");
+        return false;
+    }
+
+    File file = LittleFS.open(MODEL_FILE, "r");
+    if (!file) {
+        Logger::error("RampModel: Failed to open model for reading");
+        return false;
+    }
+
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+
+    // A model saved with other bands cannot be mapped onto these
+    if (error || doc["bandWidth"] != RAMP_MODEL_BAND_C ||
+        doc["heating"].size() != RAMP_MODEL_BANDS || doc["cooling"].size() != RAMP_MODEL_BANDS) {
+        Logger::warning("RampModel: Saved model unusable, using default rates");
+        return false;
+    }
+
+    const char* const keys[2] = { "heating", "cooling" };
+    for (uint8_t direction = HEATING; direction <= COOLING; direction++) {
+        JsonArrayConst bands = doc[keys[direction]];
+        for (uint8_t band = 0; band < RAMP_MODEL_BANDS; band++) {
+            float rate = bands[band]["rate"] | 0.0f;
+            if (rate >= MIN_RATE && rate <= MAX_RATE) {
+                rates[direction][band] = rate;
+                samples[direction][band] = bands[band]["samples"] | 0;
+            }
+        }
+    }
+
+    dirty = false;
+    Logger::info("RampModel: Loaded learned ramp rates");
+    return true;
+}
+
+bool RampModel::save() {
+    if (!LittleFS.begin()) {
+        Logger::error("RampModel: Failed to mount filesystem");
+        return false;
+    }
+
+    JsonDocument doc;
+    doc["bandWidth"] = RAMP_MODEL_BAND_C;
+
+    const char* const keys[2] = { "heating", "cooling" };
+    for (uint8_t direction = HEATING; direction <= COOLING; direction++) {
+        JsonArray bands = doc[keys[direction]].to<JsonArray>();
+        for (uint8_t band = 0; band < RAMP_MODEL_BANDS; band++) {
+            JsonObject entry = bands.add<JsonObject>();
+            entry["rate"] = rates[direction][band];
+            entry["samples"] = samples[direction][band];
+        }
+    }
+
+    File file = LittleFS.open(MODEL_FILE, "w");
+    if (!file) {
+        Logger::error("RampModel: Failed to open model for writing");
+        return false;
+    }
+
+    size_t bytesWritten = serializeJson(doc, file);
+    file.close();
+
+    if (bytesWritten == 0) {
+        Logger::error("RampModel: Failed to write model");
+        return false;
+    }
+
+    dirty = false;
+    Logger::info("RampModel: Saved learned ramp rates");
+    return true;
+}
@@ -0,0 +1,73 @@
+/**
+ * RampModel.h
+ * Learned heating and cooling rates of the PCR block
+ * Part of Axionyx Biotech IoT Platform
+ */
+
+#ifndef RAMP_MODEL_H
+#define RAMP_MODEL_H
+
+#include <Arduino.h>
+
+// Width of each temperature band with its own rates (°C)
+#ifndef RAMP_MODEL_BAND_C
+#define RAMP_MODEL_BAND_C 10
+#endif
+
+// Bands covered; temperatures beyond the last one use its rates
+#ifndef RAMP_MODEL_BANDS
+#define RAMP_MODEL_BANDS 10
+#endif
+
+// Rates assumed for a band before anything has been measured there (°C/s)
+#ifndef RAMP_MODEL_DEFAULT_HEATING
+#define RAMP_MODEL_DEFAULT_HEATING 1.0f
+#endif
+
+#ifndef RAMP_MODEL_DEFAULT_COOLING
+#define RAMP_MODEL_DEFAULT_COOLING 0.5f
+#endif
+
+/**
+ * Ramp rate in °C/s per temperature band, separately for heating and
+ * cooling, learned from the ramps of live runs. Each band's rate is a
+ * running mean of its measured spans that settles into a moving average,
+ * so it follows a heater or fan that ages. Kept in flash between runs.
+ */
+class RampModel {
+public:
+    enum Direction {
+        HEATING = 0,
+        COOLING = 1
+    };
+
+    RampModel();
+
+    // Back to the default rates
+    void reset();
+
+    // Persistence (LittleFS); load() keeps the defaults if there is no saved model
+    bool load();
+    bool save();
+    bool isDirty() const { return dirty; }
+
+    // Fold in a measured span: the block went from fromTemp to toTemp in
+    // elapsedMillis. Returns false for spans too short to give a usable rate.
+    bool observe(float fromTemp, float toTemp, uint32_t elapsedMillis);
+
+    // Predicted time to ramp from one temperature to another
+    uint32_t predictMillis(float fromTemp, float toTemp) const;
+
+    float getRate(Direction direction, uint8_t band) const { return rates[direction][band]; }
+    uint8_t getSamples(Direction direction, uint8_t band) const { return samples[direction][band]; }
+    static uint8_t bandOf(float temp);
+
+private:
+    static const char* MODEL_FILE;
+
+    float rates[2][RAMP_MODEL_BANDS];       // °C/s
+    uint8_t samples[2][RAMP_MODEL_BANDS];   // Spans measured, saturating
+    bool dirty;                             // Learned since the last save
+};
+
+#endif // RAMP_MODEL_H
@@ -10,19 +10,25 @@
 #include "../../common/wifi/WiFiManager.h"
 #include "../../common/network/HTTPServer.h"
 #include "../../common/network/WebSocketServer.h"
+#include "../../common/network/ApiMetrics.h"
+#include "../../common/network/AdmissionControl.h"
 #include "../../common/discovery/mDNSService.h"
 #include "../../common/device/DeviceIdentity.h"
 #include "../../common/utils/Logger.h"
+#include "../../common/utils/DeferredActions.h"
 
 #define PIN_LED  2   // GPIO2 / D4 — NodeMCU v2 onboard LED (active LOW)
 
 // Global instances
-DeviceConfig    config;
-WiFiManager     wifiManager(config);
-PCRDevice       pcrDevice;
-HTTPServer      httpServer(config, pcrDevice, wifiManager);
-WebSocketServer wsServer(pcrDevice);
-mDNSService     mdnsService(config);
+DeviceConfig     config;
+DeferredActions  deferredActions;
+ApiMetrics       apiMetrics;
+AdmissionControl admission(config);
+WiFiManager      wifiManager(config);
+PCRDevice        pcrDevice;
+HTTPServer       httpServer(config, pcrDevice, wifiManager, deferredActions, apiMetrics, admission);
+WebSocketServer  wsServer(pcrDevice, apiMetrics, admission);
+mDNSService      mdnsService(config);
 
 void setup() {
     pinMode(PIN_LED, OUTPUT);
@@ -79,6 +85,16 @@ void setup() {
     wsServer.begin(config.network.wsPort);
     Logger::info("WebSocket server on port " + String(config.network.wsPort));
 
+    // Telemetry also goes out as Server-Sent Events on the HTTP port
+    wsServer.onTelemetry([](const std::shared_ptr<const String>& message, uint32_t id) {
+        httpServer.streamTelemetry(message, id);
+    }, []() {
+        return httpServer.wantsTelemetry();
+    });
+    httpServer.onReplay([](uint32_t since, String& out) {
+        return wsServer.replayTelemetry(since, out);
+    });
+
     Logger::info("===========================================");
     Logger::info("Connect to WiFi: " + config.wifi.apSSID);
     Logger::info("Password: "        + config.wifi.apPassword);
@@ -98,19 +114,21 @@ void loop() {
     pcrDevice.loop();
     httpServer.loop();
     wsServer.loop();
+    deferredActions.loop();
     mdnsService.loop();
 
-    // Broadcast telemetry every second
-    static unsigned long lastTelemetry = 0;
-    if (millis() - lastTelemetry >= 1000) {
-        wsServer.broadcastTelemetry();
-        lastTelemetry = millis();
-    }
+    // Send telemetry to each subscription whose rate is due
+    wsServer.broadcastTelemetry();
 
     // Serial status every 10 seconds
     static unsigned long lastStatus = 0;
     if (millis() - lastStatus >= 10000) {
-        JsonDocument status = pcrDevice.getStatus();
+        // Read the published snapshot rather than rebuilding the status
+        JsonDocument status;
+        StatusSnapshot::FramePtr snapshot = pcrDevice.getStatusSnapshot().get();
+        if (snapshot) {
+            deserializeJson(status, snapshot->json);
+        }
 
         Logger::info("── Status ──────────────────────────────");
         Logger::info("WiFi:    " + String(wifiManager.getState()));
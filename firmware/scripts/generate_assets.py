@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""
+Asset generator for Axionyx firmware
+Turns the sources in firmware/common/assets into PROGMEM headers with a
+precomputed ETag, so catalogs and the provisioning page are served
+straight from flash.
+
+Runs as a PlatformIO pre-build script (extra_scripts = pre:...) and can
+also be run by hand:  python3 firmware/scripts/generate_assets.py
+"""
+
+import gzip
+import hashlib
+import json
+import os
+
+try:
+    FIRMWARE_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+except NameError:
+    # PlatformIO runs extra scripts without __file__; the project dir is firmware/<device>
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    FIRMWARE_DIR = os.path.abspath(os.path.join(env["PROJECT_DIR"], ".."))  # noqa: F821
+ASSETS_DIR = os.path.join(FIRMWARE_DIR, "common", "assets")
+
+# Must match the order of ProtocolManager::ProtocolType
+PROTOCOL_TYPES = [
+    "MAMMALIAN_CULTURE",
+    "BACTERIAL_CULTURE",
+    "YEAST_CULTURE",
+    "DECONTAMINATION",
+    "CUSTOM_PROTOCOL",
+]
+
+LINE_WIDTH = 96
+
+
+def load_json(name):
+    with open(os.path.join(ASSETS_DIR, name), encoding="utf-8") as f:
+        return json.load(f)
+
+
+def compact(doc):
+    return json.dumps(doc, separators=(",", ":"), ensure_ascii=False).encode("utf-8")
+
+
+def etag(data):
+    return '"' + hashlib.sha1(data).hexdigest()[:16] + '"'
+
+
+def c_tokens(data):
+    """Escape bytes for a C string literal (octal escapes never run into the next char)"""
+    tokens = []
+    for b in data:
+        c = chr(b)
+        if c == '"' or c == "\\":
+            tokens.append("\\" + c)
+        elif 0x20 <= b < 0x7f:
+            tokens.append(c)
+        else:
+            tokens.append("\\%03o" % b)
+    return tokens
+
+
+def c_escape(data):
+    return "".join(c_tokens(data))
+
+
+def c_string(data, indent="    "):
+    """Split an escaped string literal over several source lines"""
+    lines = []
+    line = ""
+    for token in c_tokens(data):
+        if len(line) + len(token) > LINE_WIDTH:
+            lines.append(indent + '"' + line + '"')
+            line = ""
+        line += token
+    if line or not lines:
+        lines.append(indent + '"' + line + '"')
+    return "\n".join(lines)
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    """Format bytes as the body of a C array initializer"""
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def minify_html(text):
+    """Drop indentation, blank lines and whole-line // comments; gzip does the rest"""
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith("//"):
+            continue
+        lines.append(line)
+    return "\n".join(lines).encode("utf-8")
+
+
+def c_float(value):
+    return repr(float(value)) + "f"
+
+
+def header(filename, description):
+    return (
+        "/**\n"
+        f" * {filename}\n"
+        f" * {description}\n"
+        " * Generated by firmware/scripts/generate_assets.py from firmware/common/assets - do not edit\n"
+        " * Part of Axionyx Biotech IoT Platform\n"
+        " */\n"
+    )
+
+
+def blob(symbol, source, data):
+    return (
+        f"// Source: common/assets/{source}\n"
+        f"static const char {symbol}_JSON[] PROGMEM =\n"
+        f"{c_string(data)};\n"
+        f"static const size_t {symbol}_JSON_LEN = {len(data)};\n"
+        f"static const char {symbol}_ETAG[] = {json.dumps(etag(data))};\n"
+    )
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path, encoding="utf-8") as f:
+            if f.read() == text:
+                return False
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+    return True
+
+
+def generate_template_catalogs():
+    programs = load_json("program_templates.json")
+    protocols = load_json("protocol_templates.json")
+
+    # The REST catalog only lists protocol summaries; the full stage data
+    # is compiled into ProtocolTemplateTable.h for the incubator itself
+    protocol_catalog = {"templates": [
+        {
+            "name": p["name"],
+            "type": PROTOCOL_TYPES.index(p["type"]),
+            "description": p["description"],
+            "stages": len(p["stages"]),
+        }
+        for p in protocols["templates"]
+    ]}
+
+    text = header("TemplateCatalogs.h", "Flash-resident template catalogs for the REST API")
+    text += "\n#ifndef TEMPLATE_CATALOGS_H\n#define TEMPLATE_CATALOGS_H\n\n#include <Arduino.h>\n\n"
+    text += "#ifdef DEVICE_TYPE_PCR\n"
+    text += blob("PROGRAM_TEMPLATES", "program_templates.json", compact(programs))
+    text += "#endif\n\n"
+    text += "#ifdef DEVICE_TYPE_INCUBATOR\n"
+    text += blob("PROTOCOL_TEMPLATES", "protocol_templates.json", compact(protocol_catalog))
+    text += "#endif\n"
+    text += "\n#endif // TEMPLATE_CATALOGS_H\n"
+
+    return write_if_changed(os.path.join(ASSETS_DIR, "TemplateCatalogs.h"), text)
+
+
+def generate_protocol_table():
+    protocols = load_json("protocol_templates.json")["templates"]
+
+    name_len = max(len(p["name"].encode("utf-8")) for p in protocols) + 1
+    desc_len = max(len(p["description"].encode("utf-8")) for p in protocols) + 1
+    stage_name_len = max(len(s["name"].encode("utf-8")) for p in protocols for s in p["stages"]) + 1
+    max_stages = max(len(p["stages"]) for p in protocols)
+
+    rows = []
+    for p in protocols:
+        a = p["alarms"]
+        stages = []
+        for s in p["stages"]:
+            stages.append(
+                "            { \"%s\", %s, %s, %s, %d, %s, %d }" % (
+                    c_escape(s["name"].encode("utf-8")), c_float(s["temperature"]),
+                    c_float(s["humidity"]), c_float(s["co2"]), s["duration"],
+                    "true" if s["ramp"] else "false", s["rampTime"]))
+        rows.append(
+            "    {\n"
+            f"        ProtocolManager::{p['type']},\n"
+            f"        \"{c_escape(p['name'].encode('utf-8'))}\",\n"
+            f"        \"{c_escape(p['description'].encode('utf-8'))}\",\n"
+            f"        {c_float(a['tempHigh'])}, {c_float(a['tempLow'])}, {c_float(a['humidityLow'])}, "
+            f"{c_float(a['co2High'])}, {c_float(a['co2Low'])},\n"
+            f"        {len(p['stages'])},\n"
+            "        {\n" + ",\n".join(stages) + "\n        }\n"
+            "    }")
+
+    text = header("ProtocolTemplateTable.h", "Flash-resident protocol template definitions")
+    text += (
+        "\n#ifndef PROTOCOL_TEMPLATE_TABLE_H\n#define PROTOCOL_TEMPLATE_TABLE_H\n\n"
+        "#include <Arduino.h>\n#include \"ProtocolManager.h\"\n\n"
+        f"#define PROTOCOL_TEMPLATE_COUNT {len(protocols)}\n"
+        f"#define PROTOCOL_TEMPLATE_MAX_STAGES {max_stages}\n\n"
+        "struct ProtocolTemplateStageDef {\n"
+        f"    char name[{stage_name_len}];\n"
+        "    float temperature;\n"
+        "    float humidity;\n"
+        "    float co2Level;\n"
+        "    uint32_t duration;\n"
+        "    bool rampToTarget;\n"
+        "    uint16_t rampTime;\n"
+        "};\n\n"
+        "struct ProtocolTemplateDef {\n"
+        "    ProtocolManager::ProtocolType type;\n"
+        f"    char name[{name_len}];\n"
+        f"    char description[{desc_len}];\n"
+        "    float tempAlarmHigh;\n"
+        "    float tempAlarmLow;\n"
+        "    float humidityAlarmLow;\n"
+        "    float co2AlarmHigh;\n"
+        "    float co2AlarmLow;\n"
+        "    uint8_t stageCount;\n"
+        "    ProtocolTemplateStageDef stages[PROTOCOL_TEMPLATE_MAX_STAGES];\n"
+        "};\n\n"
+        "static const ProtocolTemplateDef PROTOCOL_TEMPLATE_TABLE[PROTOCOL_TEMPLATE_COUNT] PROGMEM = {\n"
+        + ",\n".join(rows) +
+        "\n};\n\n#endif // PROTOCOL_TEMPLATE_TABLE_H\n"
+    )
+
+    path = os.path.join(FIRMWARE_DIR, "incubator", "src", "ProtocolTemplateTable.h")
+    return write_if_changed(path, text)
+
+
+def generate_provision_page():
+    with open(os.path.join(ASSETS_DIR, "provision.html"), encoding="utf-8") as f:
+        source = f.read()
+
+    minified = minify_html(source)
+    # mtime=0 keeps the output (and so the ETag) stable between builds
+    compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+
+    text = header("ProvisionPage.h", "Gzip-compressed captive portal page")
+    text += (
+        "\n#ifndef PROVISION_PAGE_H\n#define PROVISION_PAGE_H\n\n#include <Arduino.h>\n\n"
+        f"// Source: common/assets/provision.html ({len(source.encode('utf-8'))} bytes, "
+        f"minified {len(minified)}, gzip {len(compressed)})\n"
+        "static const uint8_t PROVISION_PAGE_GZ[] PROGMEM = {\n"
+        f"{c_bytes(compressed)}\n"
+        "};\n"
+        f"static const size_t PROVISION_PAGE_GZ_LEN = {len(compressed)};\n"
+        f"static const char PROVISION_PAGE_ETAG[] = {json.dumps(etag(compressed))};\n"
+        "\n#endif // PROVISION_PAGE_H\n"
+    )
+
+    return write_if_changed(os.path.join(ASSETS_DIR, "ProvisionPage.h"), text)
+
+
+def generate_all():
+    changed = []
+    if generate_template_catalogs():
+        changed.append("TemplateCatalogs.h")
+    if generate_protocol_table():
+        changed.append("ProtocolTemplateTable.h")
+    if generate_provision_page():
+        changed.append("ProvisionPage.h")
+    for name in changed:
+        print(f"generate_assets: updated {name}")
+
+
+if __name__ == "__main__" or "env" in globals():
+    generate_all()